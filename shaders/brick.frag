@@ -0,0 +1,18 @@
+// Fragment shader for instanced rendering of the blocks in a level
+
+#version 330 core
+
+out vec4 fragColor;
+
+in vec2 texCoords;
+flat in uint colorIndex;
+flat in uint solid;
+
+uniform sampler2D solidTexture;
+uniform sampler2D breakableTexture;
+uniform vec3 colors[5]; // block colors indexed by colorIndex
+
+void main() {
+    vec4 texel = solid != 0u ? texture(solidTexture, texCoords) : texture(breakableTexture, texCoords);
+    fragColor = vec4(colors[colorIndex], 1.0) * texel;
+}
@@ -0,0 +1,29 @@
+// Vertex shader for instanced rendering of the blocks in a level
+
+#version 330 core
+
+layout (location = 0) in vec2 iPos;
+layout (location = 1) in vec2 iTexCoords;
+layout (location = 2) in vec4 iRect; // position (xy) and size (zw) of the block
+layout (location = 3) in uvec2 iInfo; // color index (x) and flags (y)
+
+out vec2 texCoords;
+flat out uint colorIndex;
+flat out uint solid;
+
+uniform mat4 projection;
+
+const uint BRICK_ALIVE = 1u;
+const uint BRICK_SOLID = 2u;
+
+void main() {
+    texCoords = iTexCoords;
+    colorIndex = iInfo.x;
+    solid = iInfo.y & BRICK_SOLID;
+    if ((iInfo.y & BRICK_ALIVE) == 0u) {
+        // destroyed blocks collapse to a single point outside the clip volume
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    } else {
+        gl_Position = projection * vec4(iRect.xy + iPos * iRect.zw, 0.0, 1.0);
+    }
+}
@@ -1,4 +1,5 @@
 // Fragment shader for post-processing effects
+// Effects are selected at compile time: CHAOS, CONFUSE and SHAKE are defined by the PostProcessor for each variant
 
 #version 330 core
 
@@ -7,47 +8,64 @@ out vec4 fragColor;
 in vec2 texCoords;
 
 uniform sampler2D scene;
-uniform vec2 offsets[9]; // sampling offsets
-uniform int edge_kernel[9]; // 3x3 edge detection kernel
-uniform float blur_kernel[9]; // 3x3 blur kernel
-uniform bool chaos;
-uniform bool confuse;
-uniform bool shake;
+
+#if defined(CHAOS) || defined(SHAKE)
+const float offset = 1.0 / 300.0;
+const vec2 offsets[9] = vec2[]( // sampling offsets
+    vec2(-offset, offset), vec2(0.0, offset), vec2(offset, offset),
+    vec2(-offset, 0.0), vec2(0.0, 0.0), vec2(offset, 0.0),
+    vec2(-offset, -offset), vec2(0.0, -offset), vec2(offset, -offset)
+);
+#endif
+#ifdef CHAOS
+const float edge_kernel[9] = float[]( // 3x3 edge detection kernel
+    -1.0, -1.0, -1.0,
+    -1.0, 8.0, -1.0,
+    -1.0, -1.0, -1.0
+);
+#endif
+#ifdef SHAKE
+const float blur_kernel[9] = float[]( // 3x3 blur kernel
+    1.0 / 16.0, 2.0 / 16.0, 1.0 / 16.0,
+    2.0 / 16.0, 4.0 / 16.0, 2.0 / 16.0,
+    1.0 / 16.0, 2.0 / 16.0, 1.0 / 16.0
+);
+#endif
 
 void main() {
+#if defined(CHAOS) || defined(SHAKE)
+    // taking a total of 9 samples around each fragment
     vec4 color = vec4(0.0f);
-    vec3 sample[9];
-    if (chaos || shake) {
-        // taking a total of 9 samples around each fragment
-        for (int i = 0; i < 9; i++) {
-            sample[i] = vec3(texture(scene, texCoords + offsets[i]));
-        }
-    } else {
-        color = texture(scene, texCoords);
+    vec3 samples[9];
+    for (int i = 0; i < 9; i++) {
+        samples[i] = vec3(texture(scene, texCoords + offsets[i]));
     }
+#else
+    vec4 color = texture(scene, texCoords);
+#endif
     
-    if (chaos) {
-        // convoluting the samples with the edge detection kernel
-        for (int i = 0; i < 9; i++) {
-            color += vec4(sample[i] * edge_kernel[i], 0.0f);
-        }
-        color.a = 1.0f;
-    }
-    if (shake) {
-        // convoluting the samples with the blue kernel
-        for (int i = 0; i < 9; i++) {
-            color += vec4(sample[i] * blur_kernel[i], 0.0f);
-        }
-        if (chaos) {
-            // normalizing the output after both effects are applied
-            color /= 2.0f;
-        }
-        color.a = 1.0f;
+#ifdef CHAOS
+    // convoluting the samples with the edge detection kernel
+    for (int i = 0; i < 9; i++) {
+        color += vec4(samples[i] * edge_kernel[i], 0.0f);
     }
-    if (confuse) {
-        // inverting the colors
-        color = vec4(1.0f - color.rgb, 1.0f);
+    color.a = 1.0f;
+#endif
+#ifdef SHAKE
+    // convoluting the samples with the blur kernel
+    for (int i = 0; i < 9; i++) {
+        color += vec4(samples[i] * blur_kernel[i], 0.0f);
     }
+#ifdef CHAOS
+    // normalizing the output after both effects are applied
+    color /= 2.0f;
+#endif
+    color.a = 1.0f;
+#endif
+#ifdef CONFUSE
+    // inverting the colors
+    color = vec4(1.0f - color.rgb, 1.0f);
+#endif
     
     fragColor = color;
 }
@@ -1,4 +1,5 @@
 // Vertex shader for post-processing effects
+// Effects are selected at compile time: CHAOS, CONFUSE and SHAKE are defined by the PostProcessor for each variant
 
 #version 330 core
 
@@ -7,28 +8,25 @@ layout (location = 1) in vec2 iTexCoords;
 
 out vec2 texCoords;
 
-uniform bool chaos;
-uniform bool shake;
-uniform bool confuse;
 uniform float time;
 
 void main() {
     gl_Position = vec4(iPos, 0.0f, 1.0f);
     texCoords = iTexCoords;
     
-    if (chaos) {
-        // rotates texture coordinates in a circular fashion. Repeat if out of bounds.
-        float strength = 0.3;
-        texCoords = vec2(texCoords.x + sin(time) * strength, texCoords.y + cos(time) * strength);
-    }
-    if (confuse) {
-        // inverts texture coordinates
-        texCoords = vec2(1.0) - texCoords;
-    }
-    if (shake) {
-        // slightly shakes the scene by directly modifying vertex positions
-        float strength = 0.01;
-        gl_Position.x += cos(time * 10) * strength;
-        gl_Position.y += cos(time * 15) * strength;
-    }
+#ifdef CHAOS
+    // rotates texture coordinates in a circular fashion. Repeat if out of bounds.
+    float chaosStrength = 0.3;
+    texCoords = vec2(texCoords.x + sin(time) * chaosStrength, texCoords.y + cos(time) * chaosStrength);
+#endif
+#ifdef CONFUSE
+    // inverts texture coordinates
+    texCoords = vec2(1.0) - texCoords;
+#endif
+#ifdef SHAKE
+    // slightly shakes the scene by directly modifying vertex positions
+    float shakeStrength = 0.01;
+    gl_Position.x += cos(time * 10) * shakeStrength;
+    gl_Position.y += cos(time * 15) * shakeStrength;
+#endif
 }
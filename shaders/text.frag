@@ -10,7 +10,10 @@ uniform sampler2D text;
 uniform vec3 textColor;
 
 void main() {
-    // sampling the single-channel glyph texture and storing it in the alpha channel
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, texCoords).r);
-    fragColor = vec4(textColor, 1.0) * sampled;
+    // sampling the signed distance field, where 0.5 lies on the glyph outline
+    // the edge is anti-aliased over one screen pixel regardless of the text scale
+    float dist = texture(text, texCoords).r;
+    float width = fwidth(dist);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+    fragColor = vec4(textColor, alpha);
 }
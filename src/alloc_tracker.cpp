@@ -0,0 +1,52 @@
+/*
+ alloc_tracker.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the AllocationTracker class
+ A static class that counts calls to the global allocation functions, in total and per thread.
+ */
+
+#include "alloc_tracker.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// Instantiate static variables
+std::atomic<bool> AllocationTracker::Enabled(false);
+std::atomic<unsigned long long> AllocationTracker::Total(0);
+thread_local unsigned long long AllocationTracker::Thread = 0;
+thread_local unsigned int AllocationTracker::Paused = 0;
+
+// Counts an allocation of the calling thread unless it is paused
+void AllocationTracker::Record() {
+    if (Paused) {
+        return;
+    }
+    Thread++;
+    Total.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Replaces the global allocation functions, which the array forms call as well
+void *operator new(size_t size) {
+    if (AllocationTracker::Enabled.load(std::memory_order_relaxed)) {
+        AllocationTracker::Record();
+    }
+    void *memory;
+    while (!(memory = malloc(size ? size : 1))) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    free(memory);
+}
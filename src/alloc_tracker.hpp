@@ -0,0 +1,43 @@
+/*
+ alloc_tracker.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the AllocationTracker class
+ A static class that counts calls to the global allocation functions, in total and per thread.
+ */
+
+#ifndef alloc_tracker_hpp
+#define alloc_tracker_hpp
+
+#include <atomic>
+
+// Counting is off until enabled, so that an untracked run only pays for a check of a flag
+class AllocationTracker {
+public:
+    static std::atomic<bool> Enabled;
+    
+    static unsigned long long Count() { return Total.load(std::memory_order_relaxed); } // allocations made by all threads
+    static unsigned long long ThreadCount() { return Thread; } // allocations made by the calling thread
+    static void Record();
+    
+private:
+    friend class AllocationPause;
+    static std::atomic<unsigned long long> Total;
+    static thread_local unsigned long long Thread;
+    static thread_local unsigned int Paused; // nesting depth of AllocationPause on the calling thread
+    
+    AllocationTracker() {}
+};
+
+// Leaves the allocations of the calling thread uncounted while in scope
+// Used around code that allocates by design, such as exporters, tools and third-party libraries
+class AllocationPause {
+public:
+    AllocationPause() { AllocationTracker::Paused++; }
+    ~AllocationPause() { AllocationTracker::Paused--; }
+    AllocationPause(const AllocationPause &) = delete;
+    AllocationPause &operator=(const AllocationPause &) = delete;
+};
+
+#endif /* alloc_tracker_hpp */
@@ -0,0 +1,175 @@
+/*
+ asset_archive.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the AssetArchive class
+ A static reader of the packed asset archive, which is memory-mapped so that assets are read without further system calls.
+ */
+
+#include "asset_archive.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool AssetArchive::LooseFiles = false;
+bool AssetArchive::Overrides = false;
+const unsigned char *AssetArchive::Mapping = nullptr;
+size_t AssetArchive::MappingSize = 0;
+std::unordered_map<std::string, const ArchiveEntry*> AssetArchive::Index;
+
+#ifdef _WIN32
+std::vector<unsigned char> archiveData; // without mmap, the archive is read into memory with a single read
+#endif
+
+AssetArchive::AssetArchive() {}
+
+// Returns the bytes of an asset as a string, e.g. for shader sources and level files
+std::string AssetBlob::String() const {
+    return std::string((const char*)Data, Size);
+}
+
+// Maps an archive into memory and indexes its entries. Returns false if the archive is missing or invalid.
+bool AssetArchive::Open(std::string path) {
+    Close();
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    archiveData.resize((size_t)file.tellg());
+    file.seekg(0);
+    if (!file.read((char*)archiveData.data(), archiveData.size())) {
+        return false;
+    }
+    Mapping = archiveData.data();
+    MappingSize = archiveData.size();
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(ArchiveHeader)) {
+        close(fd);
+        return false;
+    }
+    void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping stays valid after the descriptor is closed
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    Mapping = (const unsigned char*)mapping;
+    MappingSize = info.st_size;
+#endif
+    
+    // validates the header and index before any entry is trusted
+    const ArchiveHeader *header = (const ArchiveHeader*)Mapping;
+    size_t indexEnd = sizeof(ArchiveHeader) + (size_t)header->NumEntries * sizeof(ArchiveEntry);
+    if (header->Magic != ARCHIVE_MAGIC || header->Version != ARCHIVE_VERSION || indexEnd > MappingSize) {
+        std::cout << "ERROR::ARCHIVE: " << path << " is not a valid asset archive" << std::endl;
+        Close();
+        return false;
+    }
+    const ArchiveEntry *entries = (const ArchiveEntry*)(Mapping + sizeof(ArchiveHeader));
+    for (uint32_t i = 0; i < header->NumEntries; i++) {
+        const ArchiveEntry &entry = entries[i];
+        if (entry.Offset > MappingSize || entry.Size > MappingSize - entry.Offset || memchr(entry.Path, '\0', ARCHIVE_PATH_LENGTH) == nullptr) {
+            std::cout << "ERROR::ARCHIVE: " << path << " is corrupt" << std::endl;
+            Close();
+            return false;
+        }
+        Index[entry.Path] = &entry;
+    }
+    if (Overrides) {
+        FindOverrides(path);
+    }
+    return true;
+}
+
+// Unmaps the archive
+void AssetArchive::Close() {
+    Index.clear();
+    if (!Mapping) {
+        return;
+    }
+#ifdef _WIN32
+    archiveData.clear();
+#else
+    munmap((void*)Mapping, MappingSize);
+#endif
+    Mapping = nullptr;
+    MappingSize = 0;
+}
+
+bool AssetArchive::IsOpen() {
+    return Mapping != nullptr;
+}
+
+// Looks up an asset by its relative path. The blob points into the archive, so no copy is made.
+// Assets are read from loose files if LooseFiles is set or no archive is open.
+// Entries overridden by loose files when the archive was opened are read from those files instead.
+// Only reads immutable state, so it may be called from any thread once the archive is open.
+bool AssetArchive::Load(const std::string &path, AssetBlob &blob) {
+    blob.Owned.clear();
+    if (LooseFiles || !Mapping) {
+        return LoadLooseFile(path, blob);
+    }
+    auto found = Index.find(path);
+    if (found == Index.end()) {
+        blob.Data = nullptr;
+        blob.Size = 0;
+        return false;
+    }
+    if (!found->second) {
+        return LoadLooseFile(path, blob);
+    }
+    blob.Data = Mapping + found->second->Offset;
+    blob.Size = found->second->Size;
+    return true;
+}
+
+// Marks the entries whose loose files in the working directory were changed after the archive was written as overridden
+// The file system is only checked here, once per entry, so loading an asset never has to
+void AssetArchive::FindOverrides(const std::string &path) {
+    std::error_code error;
+    std::filesystem::file_time_type archiveTime = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return;
+    }
+    for (auto &entry : Index) {
+        std::filesystem::file_time_type looseTime = std::filesystem::last_write_time(entry.first, error);
+        if (!error && looseTime > archiveTime) {
+            std::cout << "Overriding " << entry.first << " with its loose file" << std::endl;
+            entry.second = nullptr;
+        }
+    }
+}
+
+// Reads a loose file relative to the working directory
+bool AssetArchive::LoadLooseFile(const std::string &path, AssetBlob &blob) {
+    blob.Data = nullptr;
+    blob.Size = 0;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    blob.Owned.resize((size_t)file.tellg());
+    file.seekg(0);
+    if (!file.read((char*)blob.Owned.data(), blob.Owned.size())) {
+        blob.Owned.clear();
+        return false;
+    }
+    blob.Data = blob.Owned.data();
+    blob.Size = blob.Owned.size();
+    return true;
+}
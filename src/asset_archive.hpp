@@ -0,0 +1,67 @@
+/*
+ asset_archive.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the AssetArchive class
+ A static reader of the packed asset archive, which is memory-mapped so that assets are read without further system calls.
+ */
+
+#ifndef asset_archive_hpp
+#define asset_archive_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+const uint32_t ARCHIVE_MAGIC = 0x4B504B42; // "BKPK"
+const uint32_t ARCHIVE_VERSION = 1;
+const unsigned int ARCHIVE_PATH_LENGTH = 112; // maximum length of an asset path, including the terminating null
+const unsigned int ARCHIVE_ALIGNMENT = 16; // alignment of asset data inside the archive
+
+// Layout of the archive: a header, one index entry per asset, then the data of all assets
+struct ArchiveHeader {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t NumEntries;
+    uint32_t Reserved;
+};
+
+struct ArchiveEntry {
+    uint64_t Offset; // from the start of the archive
+    uint64_t Size;
+    char Path[ARCHIVE_PATH_LENGTH]; // relative path of the asset, e.g. "textures/ball.png"
+};
+
+// The bytes of an asset. They point into the mapped archive, or into Owned if the asset was read from a loose file.
+struct AssetBlob {
+    const unsigned char *Data = nullptr;
+    size_t Size = 0;
+    std::vector<unsigned char> Owned;
+    
+    std::string String() const;
+};
+
+class AssetArchive {
+public:
+    static bool LooseFiles; // reads every asset from loose files instead of the archive, for development
+    static bool Overrides; // reads the assets whose loose files were changed after the archive was packed from those files, for development
+    
+    static bool Open(std::string path);
+    static void Close();
+    static bool IsOpen();
+    static bool Load(const std::string &path, AssetBlob &blob);
+    
+private:
+    static const unsigned char *Mapping;
+    static size_t MappingSize;
+    static std::unordered_map<std::string, const ArchiveEntry*> Index; // null for entries overridden by a loose file
+    
+    AssetArchive();
+    static void FindOverrides(const std::string &path);
+    static bool LoadLooseFile(const std::string &path, AssetBlob &blob);
+};
+
+#endif /* asset_archive_hpp */
@@ -0,0 +1,97 @@
+/*
+ asset_loader.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the AssetLoader class
+ A singleton thread pool that prepares assets on worker threads and hands them to the OpenGL thread for uploading.
+ */
+
+#include "asset_loader.hpp"
+
+#include <GLFW/GLFW3.H>
+
+#include <algorithm>
+
+// Starts the worker threads. By default one worker is started per hardware thread.
+AssetLoader::AssetLoader(unsigned int numThreads) : NumEnqueued(0), NumFinished(0), Stopping(false) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned int i = 0; i < numThreads; i++) {
+        Workers.emplace_back(&AssetLoader::WorkerLoop, this);
+    }
+}
+
+// Stops the workers once their current jobs are done. Jobs that have not started yet are discarded.
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Stopping = true;
+        Jobs.clear();
+    }
+    JobAvailable.notify_all();
+    for (std::thread &worker : Workers) {
+        worker.join();
+    }
+}
+
+// Schedules a job on the worker threads. Called on the OpenGL thread.
+void AssetLoader::Enqueue(LoadJob job) {
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Jobs.push_back(std::move(job));
+        NumEnqueued++;
+    }
+    JobAvailable.notify_one();
+}
+
+// Runs completed uploads on the OpenGL thread until the time budget in seconds is used up
+// Returns true once every enqueued job has been uploaded
+bool AssetLoader::Poll(double budget) {
+    double deadline = glfwGetTime() + budget;
+    while (true) {
+        UploadTask upload;
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Completed.empty()) {
+                return NumFinished == NumEnqueued;
+            }
+            upload = std::move(Completed.front());
+            Completed.pop_front();
+        }
+        if (upload) {
+            upload();
+        }
+        std::lock_guard<std::mutex> lock(Mutex);
+        NumFinished++;
+        if (glfwGetTime() >= deadline) {
+            return NumFinished == NumEnqueued;
+        }
+    }
+}
+
+// Returns the fraction of enqueued jobs that have been uploaded
+float AssetLoader::Progress() {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return NumEnqueued == 0 ? 1.0f : (float)NumFinished / NumEnqueued;
+}
+
+// Takes jobs from the queue and moves their uploads to the completion queue
+void AssetLoader::WorkerLoop() {
+    while (true) {
+        LoadJob job;
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            JobAvailable.wait(lock, [this]() {return Stopping || !Jobs.empty();});
+            if (Stopping) {
+                return;
+            }
+            job = std::move(Jobs.front());
+            Jobs.pop_front();
+        }
+        UploadTask upload = job();
+        std::lock_guard<std::mutex> lock(Mutex);
+        Completed.push_back(std::move(upload));
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ asset_loader.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the AssetLoader class
+ A singleton thread pool that prepares assets on worker threads and hands them to the OpenGL thread for uploading.
+ */
+
+#ifndef asset_loader_hpp
+#define asset_loader_hpp
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A job runs on a worker thread and returns the part of its work that has to run on the OpenGL thread
+typedef std::function<void()> UploadTask;
+typedef std::function<UploadTask()> LoadJob;
+
+class AssetLoader {
+public:
+    AssetLoader(unsigned int numThreads = 0);
+    ~AssetLoader();
+    
+    void Enqueue(LoadJob job);
+    bool Poll(double budget);
+    float Progress();
+    
+private:
+    std::vector<std::thread> Workers;
+    std::deque<LoadJob> Jobs; // jobs waiting for a worker
+    std::deque<UploadTask> Completed; // uploads waiting for the OpenGL thread
+    std::mutex Mutex;
+    std::condition_variable JobAvailable;
+    unsigned int NumEnqueued;
+    unsigned int NumFinished; // jobs whose upload has run
+    bool Stopping;
+    
+    void WorkerLoop();
+};
+
+#endif /* asset_loader_hpp */
@@ -0,0 +1,277 @@
+/*
+ audio.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the AudioEngine class
+ Mixes preloaded sounds on its own thread, which the game commands through a lock-free queue.
+ */
+
+#include "audio.hpp"
+#include "asset_archive.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// Declaration of helper methods
+bool DecodeWav(const unsigned char *data, size_t size, std::vector<short> &samples, unsigned int &channels, unsigned int &sampleRate);
+bool DecodeWithIrrKlang(irrklang::ISoundEngine *decoder, const std::string &path, const AssetBlob &blob, std::vector<short> &samples, unsigned int &channels, unsigned int &sampleRate);
+void ConvertSamples(const std::vector<short> &samples, unsigned int channels, unsigned int sampleRate, AudioSound &sound);
+unsigned int ReadU16(const unsigned char *data);
+unsigned int ReadU32(const unsigned char *data);
+
+AudioEngine::AudioEngine(const AudioSettings &settings) : Settings(settings), VoicesStarted(0), Output(nullptr), Decoder(nullptr), Running(false) {
+}
+
+AudioEngine::~AudioEngine() {
+    if (Running) {
+        Running = false;
+        Mixer.join();
+    }
+    delete Output;
+    if (Decoder) {
+        Decoder->drop();
+    }
+}
+
+// Reads a sound from the assets and decodes it completely, so that playing it never touches a file or a decoder
+// Must be called before Start. Returns the sound's id, or AUDIO_NO_SOUND if it cannot be loaded.
+// maxVoices limits the copies of the sound mixed at once, and cooldown is the time in seconds in which it is not played again
+unsigned int AudioEngine::Load(const std::string &path, unsigned int maxVoices, float cooldown) {
+    AssetBlob blob;
+    if (!AssetArchive::Load(path, blob)) {
+        std::cout << "ERROR::AUDIO: Failed to load " << path << std::endl;
+        return AUDIO_NO_SOUND;
+    }
+    std::vector<short> samples;
+    unsigned int channels = 0, sampleRate = 0;
+    // PCM WAV files are read directly, anything else is decoded by irrKlang
+    if (!DecodeWav(blob.Data, blob.Size, samples, channels, sampleRate)) {
+        if (!Decoder) {
+            Decoder = irrklang::createIrrKlangDevice(irrklang::ESOD_NULL);
+        }
+        if (!Decoder || !DecodeWithIrrKlang(Decoder, path, blob, samples, channels, sampleRate)) {
+            std::cout << "ERROR::AUDIO: Failed to decode " << path << std::endl;
+            return AUDIO_NO_SOUND;
+        }
+    }
+    AudioSound sound;
+    ConvertSamples(samples, channels, sampleRate, sound);
+    if (sound.Frames == 0) {
+        std::cout << "ERROR::AUDIO: " << path << " is empty" << std::endl;
+        return AUDIO_NO_SOUND;
+    }
+    sound.MaxVoices = std::max(maxVoices, 1u);
+    sound.Cooldown = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(cooldown));
+    sound.LastPlayed = std::chrono::steady_clock::now() - sound.Cooldown;
+    Sounds.push_back(std::move(sound));
+    return (unsigned int)Sounds.size() - 1;
+}
+
+// Opens the output and starts mixing. Called once all sounds are loaded.
+// Falls back to the null output if the device or file cannot be opened, so the game runs the same without sound.
+void AudioEngine::Start() {
+    if (Decoder) {
+        Decoder->drop();
+        Decoder = nullptr;
+    }
+    if (Settings.Backend == AUDIO_DEVICE) {
+        Output = new DeviceAudioOutput();
+    } else if (Settings.Backend == AUDIO_WAV) {
+        Output = new WavAudioOutput(Settings.FilePath);
+    }
+    if (Output && !Output->IsOpen()) {
+        std::cout << "ERROR::AUDIO: Continuing without sound" << std::endl;
+        delete Output;
+        Output = nullptr;
+    }
+    if (!Output) {
+        Output = new NullAudioOutput();
+    }
+    Running = true;
+    Mixer = std::thread(&AudioEngine::RunMixer, this);
+}
+
+// Queues a sound to be played. Never blocks or allocates.
+// Called by one thread at a time. Returns false if the sound is within its cooldown or the queue is full.
+bool AudioEngine::Play(unsigned int sound, float volume, bool loop) {
+    if (sound >= Sounds.size()) {
+        return false;
+    }
+    AudioSound &target = Sounds[sound];
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - target.LastPlayed < target.Cooldown) {
+        return false;
+    }
+    if (!Commands.Push({sound, volume, loop})) {
+        return false;
+    }
+    target.LastPlayed = now;
+    return true;
+}
+
+// Applies the queued commands and mixes a block at a time until stopped. The output paces the loop to real time.
+void AudioEngine::RunMixer() {
+    while (Running.load(std::memory_order_acquire)) {
+        AudioCommand command;
+        while (Commands.Pop(command)) {
+            StartVoice(command);
+        }
+        MixBlock();
+        Output->Write(Block, AUDIO_BLOCK_FRAMES);
+    }
+}
+
+// Assigns a voice to a sound. A sound at its voice limit replaces its oldest voice.
+// Otherwise a free voice is taken, or the oldest voice that does not loop, so music is never cut off by effects.
+void AudioEngine::StartVoice(const AudioCommand &command) {
+    unsigned int playing = 0;
+    AudioVoice *oldestOfSound = nullptr, *unused = nullptr, *oldest = nullptr;
+    for (AudioVoice &voice : Voices) {
+        if (voice.Sound == AUDIO_NO_SOUND) {
+            unused = unused ? unused : &voice;
+        } else if (voice.Sound == command.Sound) {
+            playing++;
+            if (!oldestOfSound || voice.Started < oldestOfSound->Started) {
+                oldestOfSound = &voice;
+            }
+        }
+        if (voice.Sound != AUDIO_NO_SOUND && !voice.Loop && (!oldest || voice.Started < oldest->Started)) {
+            oldest = &voice;
+        }
+    }
+    AudioVoice *voice = playing >= Sounds[command.Sound].MaxVoices ? oldestOfSound : (unused ? unused : oldest);
+    if (!voice) {
+        return; // every voice loops
+    }
+    voice->Sound = command.Sound;
+    voice->Frame = 0;
+    voice->Volume = command.Volume;
+    voice->Loop = command.Loop;
+    voice->Started = VoicesStarted++;
+}
+
+// Adds up the voices into the next block of samples, clamped to 16 bits
+void AudioEngine::MixBlock() {
+    std::fill(Mix, Mix + AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS, 0.0f);
+    for (AudioVoice &voice : Voices) {
+        if (voice.Sound == AUDIO_NO_SOUND) {
+            continue;
+        }
+        const AudioSound &sound = Sounds[voice.Sound];
+        for (unsigned int i = 0; i < AUDIO_BLOCK_FRAMES; i++) {
+            if (voice.Frame == sound.Frames) {
+                if (!voice.Loop) {
+                    voice.Sound = AUDIO_NO_SOUND;
+                    break;
+                }
+                voice.Frame = 0;
+            }
+            const short *frame = &sound.Samples[voice.Frame++ * AUDIO_CHANNELS];
+            Mix[i * AUDIO_CHANNELS] += frame[0] * voice.Volume;
+            Mix[i * AUDIO_CHANNELS + 1] += frame[1] * voice.Volume;
+        }
+    }
+    for (unsigned int i = 0; i < AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS; i++) {
+        Block[i] = (short)std::min(std::max(Mix[i], -32768.0f), 32767.0f);
+    }
+}
+
+// Reads the samples of an uncompressed 8 or 16-bit PCM WAV file. Returns false for anything else.
+bool DecodeWav(const unsigned char *data, size_t size, std::vector<short> &samples, unsigned int &channels, unsigned int &sampleRate) {
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    unsigned int bitsPerSample = 0;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const unsigned char *chunk = data + offset;
+        size_t chunkSize = std::min((size_t)ReadU32(chunk + 4), size - offset - 8);
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16) {
+            if (ReadU16(chunk + 8) != 1) {
+                return false; // compressed or extensible formats
+            }
+            channels = ReadU16(chunk + 10);
+            sampleRate = ReadU32(chunk + 12);
+            bitsPerSample = ReadU16(chunk + 22);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (channels == 0 || sampleRate == 0 || (bitsPerSample != 8 && bitsPerSample != 16)) {
+                return false; // no format chunk before the data, or an unsupported sample size
+            }
+            const unsigned char *sample = chunk + 8;
+            size_t count = chunkSize / (bitsPerSample / 8) / channels * channels;
+            samples.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                samples[i] = bitsPerSample == 8 ? (short)((sample[i] - 128) << 8) : (short)ReadU16(sample + i * 2);
+            }
+            return true;
+        }
+        offset += 8 + chunkSize + (chunkSize & 1); // chunks are padded to an even size
+    }
+    return false;
+}
+
+// Decodes a sound through irrKlang, which keeps the decoded samples of a sound source that is not streamed
+bool DecodeWithIrrKlang(irrklang::ISoundEngine *decoder, const std::string &path, const AssetBlob &blob, std::vector<short> &samples, unsigned int &channels, unsigned int &sampleRate) {
+    irrklang::ISoundSource *source = decoder->addSoundSourceFromMemory((void*)blob.Data, (int)blob.Size, path.c_str(), true);
+    if (!source) {
+        return false;
+    }
+    source->setForcedStreamingThreshold(-1);
+    source->setStreamMode(irrklang::ESM_NO_STREAMING);
+    const void *data = source->getSampleData();
+    irrklang::SAudioStreamFormat format = source->getAudioFormat();
+    bool decoded = data && format.ChannelCount > 0 && format.SampleRate > 0;
+    if (decoded) {
+        channels = format.ChannelCount;
+        sampleRate = format.SampleRate;
+        size_t count = (size_t)format.FrameCount * channels;
+        samples.resize(count);
+        if (format.SampleFormat == irrklang::ESF_U8) {
+            const unsigned char *sample = (const unsigned char*)data;
+            for (size_t i = 0; i < count; i++) {
+                samples[i] = (short)((sample[i] - 128) << 8);
+            }
+        } else {
+            memcpy(samples.data(), data, count * sizeof(short));
+        }
+    }
+    decoder->removeSoundSource(source);
+    return decoded;
+}
+
+// Converts interleaved samples to stereo at the output rate, interpolating linearly between frames
+// Mono sounds are played on both channels, and channels past the second are dropped
+void ConvertSamples(const std::vector<short> &samples, unsigned int channels, unsigned int sampleRate, AudioSound &sound) {
+    size_t frames = samples.size() / channels;
+    if (frames == 0) {
+        return;
+    }
+    sound.Frames = (unsigned int)((unsigned long long)frames * AUDIO_SAMPLE_RATE / sampleRate);
+    sound.Samples.resize((size_t)sound.Frames * AUDIO_CHANNELS);
+    double step = (double)sampleRate / AUDIO_SAMPLE_RATE;
+    unsigned int right = channels > 1 ? 1 : 0;
+    for (size_t i = 0; i < sound.Frames; i++) {
+        double position = i * step;
+        size_t first = std::min((size_t)position, frames - 1);
+        size_t second = std::min(first + 1, frames - 1);
+        float weight = (float)(position - first);
+        for (unsigned int channel = 0; channel < AUDIO_CHANNELS; channel++) {
+            unsigned int source = channel == 0 ? 0 : right;
+            float a = samples[first * channels + source];
+            float b = samples[second * channels + source];
+            sound.Samples[i * AUDIO_CHANNELS + channel] = (short)std::lround(a + (b - a) * weight);
+        }
+    }
+}
+
+// Reads little-endian integers from a file
+unsigned int ReadU16(const unsigned char *data) {
+    return data[0] | data[1] << 8;
+}
+
+unsigned int ReadU32(const unsigned char *data) {
+    return data[0] | data[1] << 8 | data[2] << 16 | (unsigned int)data[3] << 24;
+}
@@ -0,0 +1,91 @@
+/*
+ audio.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the AudioEngine class
+ Mixes preloaded sounds on its own thread, which the game commands through a lock-free queue.
+ */
+
+#ifndef audio_hpp
+#define audio_hpp
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio_output.hpp"
+#include "spsc_queue.hpp"
+
+const unsigned int AUDIO_BLOCK_FRAMES = 256; // frames mixed at a time, about 6 ms
+const unsigned int AUDIO_MAX_VOICES = 16; // sounds mixed at once
+const unsigned int AUDIO_COMMANDS = 256; // commands queued for the mixer
+const unsigned int AUDIO_NO_SOUND = 0xFFFFFFFF;
+
+enum AudioBackend {
+    AUDIO_DEVICE,
+    AUDIO_NULL, // mixes without playing, for machines without audio hardware
+    AUDIO_WAV // records the mix to a file
+};
+
+// Settings of the audio, configurable from the command line
+struct AudioSettings {
+    AudioBackend Backend = AUDIO_DEVICE;
+    std::string FilePath = "breakout.wav"; // where the WAV backend records to
+};
+
+// A sound to start playing
+struct AudioCommand {
+    unsigned int Sound;
+    float Volume;
+    bool Loop;
+};
+
+// A sound decoded to interleaved stereo samples at the output rate, with its limits on playback
+struct AudioSound {
+    std::vector<short> Samples;
+    unsigned int Frames = 0;
+    unsigned int MaxVoices; // voices of the sound mixed at once, a new one replaces the oldest
+    std::chrono::steady_clock::duration Cooldown; // a sound played again within its cooldown is skipped
+    std::chrono::steady_clock::time_point LastPlayed; // only used by the thread playing sounds
+};
+
+// A sound being mixed. Only used by the mixer thread.
+struct AudioVoice {
+    unsigned int Sound = AUDIO_NO_SOUND;
+    unsigned int Frame = 0; // next frame to mix
+    float Volume = 1.0f;
+    bool Loop = false;
+    unsigned long long Started = 0; // order in which the voices were started, to find the oldest
+};
+
+class AudioEngine {
+public:
+    AudioEngine(const AudioSettings &settings);
+    ~AudioEngine();
+    
+    unsigned int Load(const std::string &path, unsigned int maxVoices = 4, float cooldown = 0.03f);
+    void Start();
+    bool Play(unsigned int sound, float volume = 1.0f, bool loop = false);
+    
+private:
+    AudioSettings Settings;
+    std::vector<AudioSound> Sounds; // only changed before the mixer starts
+    SPSCQueue<AudioCommand, AUDIO_COMMANDS> Commands;
+    AudioVoice Voices[AUDIO_MAX_VOICES];
+    unsigned long long VoicesStarted;
+    float Mix[AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS];
+    short Block[AUDIO_BLOCK_FRAMES * AUDIO_CHANNELS];
+    AudioOutput *Output;
+    irrklang::ISoundEngine *Decoder; // decodes compressed sounds while loading, released once the mixer starts
+    std::atomic<bool> Running;
+    std::thread Mixer;
+    
+    void RunMixer();
+    void StartVoice(const AudioCommand &command);
+    void MixBlock();
+};
+
+#endif /* audio_hpp */
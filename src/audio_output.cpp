@@ -0,0 +1,177 @@
+/*
+ audio_output.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the AudioOutput class and its implementations
+ Destinations of the mixed audio: the sound device, a WAV file, or nowhere.
+ */
+
+#include "audio_output.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+const char *DEVICE_STREAM_NAME = "breakout.mixer"; // name of the placeholder sound that irrKlang opens as the mixer's stream
+
+// Sleeps until a block of frames is due, counting from the first block written
+void AudioOutput::WaitForBlock(unsigned int frames) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!Started || now - Due > std::chrono::milliseconds(100)) {
+        Due = now; // after a stall, the mix restarts from the current time instead of catching up
+        Started = true;
+    }
+    std::this_thread::sleep_until(Due);
+    Due += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>((double)frames / AUDIO_SAMPLE_RATE));
+}
+
+void NullAudioOutput::Write(const short *samples, unsigned int frames) {
+    WaitForBlock(frames);
+}
+
+WavAudioOutput::WavAudioOutput(const std::string &path) : File(fopen(path.c_str(), "wb")), Frames(0) {
+    if (!File) {
+        std::cout << "ERROR::AUDIO: Could not write " << path << std::endl;
+        return;
+    }
+    WriteHeader();
+}
+
+WavAudioOutput::~WavAudioOutput() {
+    if (File) {
+        fseek(File, 0, SEEK_SET);
+        WriteHeader();
+        fclose(File);
+    }
+}
+
+void WavAudioOutput::Write(const short *samples, unsigned int frames) {
+    WaitForBlock(frames);
+    fwrite(samples, sizeof(short) * AUDIO_CHANNELS, frames, File);
+    Frames += frames;
+}
+
+// Writes the RIFF header of a 16-bit PCM file with the frames written so far. Assumes a little-endian machine, like the WAV format.
+void WavAudioOutput::WriteHeader() {
+    unsigned int dataSize = (unsigned int)(Frames * AUDIO_CHANNELS * sizeof(short));
+    unsigned int riffSize = 36 + dataSize;
+    unsigned int formatSize = 16;
+    unsigned short format = 1; // PCM
+    unsigned short channels = AUDIO_CHANNELS;
+    unsigned int sampleRate = AUDIO_SAMPLE_RATE;
+    unsigned int byteRate = AUDIO_SAMPLE_RATE * AUDIO_CHANNELS * sizeof(short);
+    unsigned short blockAlign = AUDIO_CHANNELS * sizeof(short);
+    unsigned short bitsPerSample = 16;
+    fwrite("RIFF", 1, 4, File);
+    fwrite(&riffSize, 4, 1, File);
+    fwrite("WAVEfmt ", 1, 8, File);
+    fwrite(&formatSize, 4, 1, File);
+    fwrite(&format, 2, 1, File);
+    fwrite(&channels, 2, 1, File);
+    fwrite(&sampleRate, 4, 1, File);
+    fwrite(&byteRate, 4, 1, File);
+    fwrite(&blockAlign, 2, 1, File);
+    fwrite(&bitsPerSample, 2, 1, File);
+    fwrite("data", 1, 4, File);
+    fwrite(&dataSize, 4, 1, File);
+    fseek(File, 0, SEEK_END);
+}
+
+// The mixer's output as an endless irrKlang stream. Called on irrKlang's own thread, which plays silence while the buffer runs dry.
+class MixerStream : public irrklang::IAudioStream {
+public:
+    MixerStream(SPSCQueue<unsigned int, AUDIO_DEVICE_BUFFER> &buffer) : Buffer(buffer) {}
+    
+    irrklang::SAudioStreamFormat getFormat() override {
+        irrklang::SAudioStreamFormat format;
+        format.ChannelCount = AUDIO_CHANNELS;
+        format.FrameCount = 0x7FFFFFFF; // irrKlang has no endless streams, the sound is looped after over 13 hours
+        format.SampleRate = AUDIO_SAMPLE_RATE;
+        format.SampleFormat = irrklang::ESF_S16;
+        return format;
+    }
+    
+    bool setPosition(irrklang::ik_s32 pos) override {
+        return true;
+    }
+    
+    bool getIsSeekingSupported() override {
+        return false;
+    }
+    
+    irrklang::ik_s32 readFrames(void *target, irrklang::ik_s32 frameCountToRead) override {
+        unsigned int *frames = (unsigned int*)target;
+        irrklang::ik_s32 i = 0;
+        while (i < frameCountToRead && Buffer.Pop(frames[i])) {
+            i++;
+        }
+        memset(frames + i, 0, (frameCountToRead - i) * sizeof(unsigned int));
+        return frameCountToRead;
+    }
+    
+private:
+    SPSCQueue<unsigned int, AUDIO_DEVICE_BUFFER> &Buffer;
+};
+
+// Hands irrKlang the mixer's stream when it opens the placeholder sound
+class MixerStreamLoader : public irrklang::IAudioStreamLoader {
+public:
+    MixerStreamLoader(MixerStream *stream) : Stream(stream) {}
+    ~MixerStreamLoader() { Stream->drop(); }
+    
+    bool isALoadableFileExtension(const irrklang::ik_c8 *fileName) override {
+        return strcmp(fileName, DEVICE_STREAM_NAME) == 0;
+    }
+    
+    irrklang::IAudioStream *createAudioStream(irrklang::IFileReader *file) override {
+        Stream->grab();
+        return Stream;
+    }
+    
+private:
+    MixerStream *Stream;
+};
+
+DeviceAudioOutput::DeviceAudioOutput() : Engine(irrklang::createIrrKlangDevice()) {
+    if (!Engine) {
+        std::cout << "ERROR::AUDIO: Could not open the sound device" << std::endl;
+        return;
+    }
+    MixerStreamLoader *loader = new MixerStreamLoader(new MixerStream(Buffer));
+    Engine->registerAudioStreamLoader(loader);
+    loader->drop();
+    static char placeholder[4] = {};
+    irrklang::ISoundSource *source = Engine->addSoundSourceFromMemory(placeholder, sizeof(placeholder), DEVICE_STREAM_NAME, true);
+    if (source) {
+        source->setStreamMode(irrklang::ESM_STREAMING); // the endless stream must never be decoded up front
+    }
+    if (!source || !Engine->play2D(source, true)) {
+        std::cout << "ERROR::AUDIO: Could not stream to the sound device" << std::endl;
+        Engine->drop();
+        Engine = nullptr;
+    }
+}
+
+DeviceAudioOutput::~DeviceAudioOutput() {
+    if (Engine) {
+        Engine->drop(); // stops irrKlang's thread before the buffer goes away
+    }
+}
+
+// Waits until the device has played the buffer down to the lead, rather than for the clock, as the device consumes frames in real time
+// Keeping the buffer short means a sound is mixed at most a couple of blocks before the device plays it
+// A block is dropped if the device stops taking frames, so that the mixer can still be stopped
+void DeviceAudioOutput::Write(const short *samples, unsigned int frames) {
+    std::chrono::steady_clock::time_point timeout = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(AUDIO_DEVICE_TIMEOUT));
+    while (Buffer.Size() + frames > AUDIO_DEVICE_LEAD) {
+        if (std::chrono::steady_clock::now() > timeout) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (unsigned int i = 0; i < frames; i++) {
+        unsigned int frame = (unsigned short)samples[2 * i] | (unsigned int)(unsigned short)samples[2 * i + 1] << 16;
+        Buffer.Push(frame);
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ audio_output.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the AudioOutput class and its implementations
+ Destinations of the mixed audio: the sound device, a WAV file, or nowhere.
+ */
+
+#ifndef audio_output_hpp
+#define audio_output_hpp
+
+#include <irrKlang/irrKlang.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "spsc_queue.hpp"
+
+const unsigned int AUDIO_SAMPLE_RATE = 44100;
+const unsigned int AUDIO_CHANNELS = 2; // samples are interleaved signed 16-bit stereo
+const size_t AUDIO_DEVICE_BUFFER = 1024; // capacity of the buffer between the mixer and the device, in frames
+const size_t AUDIO_DEVICE_LEAD = 512; // frames the mixer may be ahead of the device, about 12 ms, which bounds the latency of a new sound
+const double AUDIO_DEVICE_TIMEOUT = 0.1; // seconds a block waits for room in the device buffer before it is dropped
+
+// Receives each block of mixed frames on the mixer thread. Write returns once the block is due, so the mixer runs in real time.
+class AudioOutput {
+public:
+    virtual ~AudioOutput() {}
+    virtual bool IsOpen() const = 0;
+    virtual void Write(const short *samples, unsigned int frames) = 0;
+    
+protected:
+    std::chrono::steady_clock::time_point Due; // when the next block is due
+    bool Started = false;
+    
+    void WaitForBlock(unsigned int frames);
+};
+
+// Discards the mix, for machines without audio hardware
+class NullAudioOutput : public AudioOutput {
+public:
+    bool IsOpen() const override { return true; }
+    void Write(const short *samples, unsigned int frames) override;
+};
+
+// Records the mix to a 16-bit PCM WAV file, e.g. to check the audio of a run without audio hardware
+class WavAudioOutput : public AudioOutput {
+public:
+    WavAudioOutput(const std::string &path);
+    ~WavAudioOutput();
+    
+    bool IsOpen() const override { return File != nullptr; }
+    void Write(const short *samples, unsigned int frames) override;
+    
+private:
+    FILE *File;
+    unsigned long long Frames; // frames written, filled into the header on close
+    
+    void WriteHeader();
+};
+
+// Plays the mix on the sound device through irrKlang, which pulls it from a lock-free buffer as an endless stream
+class DeviceAudioOutput : public AudioOutput {
+public:
+    DeviceAudioOutput();
+    ~DeviceAudioOutput();
+    
+    bool IsOpen() const override { return Engine != nullptr; }
+    void Write(const short *samples, unsigned int frames) override;
+    
+private:
+    SPSCQueue<unsigned int, AUDIO_DEVICE_BUFFER> Buffer; // one packed stereo frame per item, written by the mixer and read by irrKlang
+    irrklang::ISoundEngine *Engine;
+};
+
+#endif /* audio_output_hpp */
@@ -0,0 +1,106 @@
+/*
+ benchmark.cpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Implementation of the Benchmark class
+ Records the frame times of a scripted benchmark run and reports their percentiles as JSON.
+ */
+
+#include "benchmark.hpp"
+#include "frame_pacer.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Declaration of helper methods
+void WriteTimes(std::ostream &json, const char *name, std::vector<double> times);
+
+Benchmark::Benchmark(const BenchmarkSettings &settings) : Settings(settings) {
+    Samples.reserve(settings.Ticks);
+}
+
+// Adds the times of a tick. Called once per simulation step.
+void Benchmark::Record(const BenchmarkSample &sample) {
+    Samples.push_back(sample);
+}
+
+// Writes the settings of the run, the percentiles of its times and its allocations after the warmup
+// Returns false if the report cannot be written, or if any frame after the warmup allocated
+// renderer names the OpenGL implementation, as runs are only comparable on the same one
+bool Benchmark::Report(const std::string &renderer, unsigned int destroyedBricks) const {
+    std::vector<double> simulation, render, frame;
+    unsigned int allocatingFrames = 0;
+    unsigned long long allocations = 0;
+    int firstAllocatingTick = -1;
+    for (unsigned int i = 0; i < Samples.size(); i++) {
+        const BenchmarkSample &sample = Samples[i];
+        simulation.push_back(sample.Simulation);
+        render.push_back(sample.Render);
+        frame.push_back(sample.Frame);
+        if (i >= BENCHMARK_WARMUP_TICKS && sample.Allocations > 0) {
+            if (allocatingFrames++ == 0) {
+                firstAllocatingTick = (int)i;
+            }
+            allocations += sample.Allocations;
+        }
+    }
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"level\": ";
+    if (Settings.Level == BENCHMARK_STRESS_LEVEL) {
+        json << "\"stress\",\n  \"stress_scale\": " << Settings.StressScale << ",\n";
+    } else {
+        json << Settings.Level << ",\n";
+    }
+    json << "  \"seed\": " << Settings.Seed << ",\n";
+    json << "  \"ticks\": " << Samples.size() << ",\n";
+    json << "  \"headless\": " << (Settings.Headless ? "true" : "false") << ",\n";
+    json << "  \"renderer\": \"" << renderer << "\",\n";
+    json << "  \"destroyed_bricks\": " << destroyedBricks << ",\n";
+    json << "  \"warmup_ticks\": " << BENCHMARK_WARMUP_TICKS << ",\n";
+    json << "  \"steady_state_allocating_frames\": " << allocatingFrames << ",\n";
+    json << "  \"steady_state_allocations\": " << allocations << ",\n";
+    WriteTimes(json, "simulation_ms", simulation);
+    json << ",\n";
+    WriteTimes(json, "render_ms", render);
+    json << ",\n";
+    WriteTimes(json, "frame_ms", frame);
+    json << "\n}\n";
+
+    if (Settings.OutputPath.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(Settings.OutputPath);
+        if (!(file << json.str())) {
+            std::cout << "ERROR::BENCHMARK: Could not write report " << Settings.OutputPath << std::endl;
+            return false;
+        }
+    }
+    if (allocatingFrames > 0) {
+        std::cout << "ERROR::BENCHMARK: " << allocatingFrames << " frames after the warmup allocated " << allocations << " times, the first at tick " << firstAllocatingTick << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Writes the percentiles of a series of times as a JSON member, in milliseconds
+void WriteTimes(std::ostream &json, const char *name, std::vector<double> times) {
+    json << "  \"" << name << "\": {";
+    if (times.empty()) {
+        json << "}";
+        return;
+    }
+    double total = 0.0;
+    for (double time : times) {
+        total += time;
+    }
+    json << "\"mean\": " << total / times.size() * 1000.0;
+    json << ", \"p50\": " << Percentile(times, 0.5) * 1000.0;
+    json << ", \"p95\": " << Percentile(times, 0.95) * 1000.0;
+    json << ", \"p99\": " << Percentile(times, 0.99) * 1000.0;
+    json << ", \"max\": " << Percentile(times, 1.0) * 1000.0 << "}";
+}
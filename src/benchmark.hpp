@@ -0,0 +1,51 @@
+/*
+ benchmark.hpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Declaration of the Benchmark class
+ Records the frame times of a scripted benchmark run and reports their percentiles as JSON.
+ */
+
+#ifndef benchmark_hpp
+#define benchmark_hpp
+
+#include <string>
+#include <vector>
+
+const unsigned int BENCHMARK_STRESS_LEVEL = 0xFFFFFFFF; // stands in for the generated stress level
+const unsigned int BENCHMARK_WARMUP_TICKS = 240; // first ticks, which may allocate while buffers and caches grow to their working size
+
+// Settings of a benchmark run, configurable from the command line
+struct BenchmarkSettings {
+    bool Enabled = false;
+    unsigned int Level = 0; // index of a level in levels/, or BENCHMARK_STRESS_LEVEL
+    unsigned int StressScale = 4; // the stress level has 15 columns and 8 rows of blocks per unit of scale
+    unsigned int Seed = 1;
+    unsigned int Ticks = 3600; // simulation steps to run, 30 seconds of play
+    bool Headless = false; // renders to a hidden window
+    std::string OutputPath; // where the report is written, standard output if empty
+};
+
+// Times of one simulation step and the frame rendered after it, in seconds, and the heap allocations they made
+struct BenchmarkSample {
+    double Simulation;
+    double Render; // recording, submitting and waiting for the GPU to finish
+    double Frame; // everything including the buffer swap
+    unsigned long long Allocations; // calls to operator new made by the step and the recording of the frame
+};
+
+class Benchmark {
+public:
+    BenchmarkSettings Settings;
+
+    Benchmark(const BenchmarkSettings &settings);
+
+    void Record(const BenchmarkSample &sample);
+    bool Report(const std::string &renderer, unsigned int destroyedBricks) const;
+
+private:
+    std::vector<BenchmarkSample> Samples;
+};
+
+#endif /* benchmark_hpp */
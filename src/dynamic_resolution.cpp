@@ -0,0 +1,71 @@
+/*
+ dynamic_resolution.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the DynamicResolution class
+ A singleton controller that adjusts the render scale from measured GPU frame times to hold a target frame rate.
+ */
+
+#include "dynamic_resolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Timestamp queries are used rather than GL_TIME_ELAPSED so that they never conflict with other active timer queries
+DynamicResolution::DynamicResolution(float targetFrameRate, float scale, float minScale, float maxScale) : Scale(scale), MinScale(minScale), MaxScale(maxScale), TargetFrameTime(1.0f / targetFrameRate), GPUFrameTime(0.0f), Frame(0), FramesSinceChange(0) {
+    glGenQueries(DYNRES_QUERY_FRAMES * 2, &Queries[0][0]);
+}
+
+DynamicResolution::~DynamicResolution() {
+    glDeleteQueries(DYNRES_QUERY_FRAMES * 2, &Queries[0][0]);
+}
+
+// Records the GPU timestamp at which the frame starts. Called before anything is rendered.
+void DynamicResolution::BeginFrame() {
+    glQueryCounter(Queries[Frame % DYNRES_QUERY_FRAMES][0], GL_TIMESTAMP);
+}
+
+// Records the GPU timestamp at which the frame ends and reads back the oldest frame still in flight
+// Returns true if the render scale was changed
+bool DynamicResolution::EndFrame() {
+    glQueryCounter(Queries[Frame % DYNRES_QUERY_FRAMES][1], GL_TIMESTAMP);
+    Frame++;
+    FramesSinceChange++;
+    if (Frame < DYNRES_QUERY_FRAMES) {
+        return false;
+    }
+    
+    // the oldest query is read back only if it is available, so the CPU never waits for the GPU
+    unsigned int *oldest = Queries[Frame % DYNRES_QUERY_FRAMES];
+    GLint available = 0;
+    glGetQueryObjectiv(oldest[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return false;
+    }
+    GLuint64 start, end;
+    glGetQueryObjectui64v(oldest[0], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(oldest[1], GL_QUERY_RESULT, &end);
+    float frameTime = (end - start) * 1e-9f;
+    GPUFrameTime = GPUFrameTime == 0.0f ? frameTime : GPUFrameTime * 0.9f + frameTime * 0.1f;
+    if (FramesSinceChange < DYNRES_COOLDOWN) {
+        return false;
+    }
+    
+    // the cost of a frame is roughly proportional to its pixel count, i.e. to the square of the scale
+    // the scale is only lowered when over budget and raised when comfortably under it, which prevents oscillation
+    float target = Scale;
+    if (GPUFrameTime > TargetFrameTime) {
+        target = Scale * std::sqrt(TargetFrameTime * 0.9f / GPUFrameTime);
+    } else if (GPUFrameTime < TargetFrameTime * 0.6f) {
+        target = Scale * std::min(std::sqrt(TargetFrameTime * 0.8f / GPUFrameTime), 1.25f);
+    }
+    target = std::round(target / DYNRES_STEP) * DYNRES_STEP;
+    target = std::min(std::max(target, MinScale), MaxScale);
+    if (std::abs(target - Scale) < DYNRES_STEP * 0.5f) {
+        return false;
+    }
+    Scale = target;
+    FramesSinceChange = 0;
+    return true;
+}
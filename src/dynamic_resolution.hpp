@@ -0,0 +1,39 @@
+/*
+ dynamic_resolution.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the DynamicResolution class
+ A singleton controller that adjusts the render scale from measured GPU frame times to hold a target frame rate.
+ */
+
+#ifndef dynamic_resolution_hpp
+#define dynamic_resolution_hpp
+
+#include <glad/glad.h>
+
+const unsigned int DYNRES_QUERY_FRAMES = 4; // frames in flight before a timestamp query is read back
+const unsigned int DYNRES_COOLDOWN = 30; // minimum number of frames between two scale changes
+const float DYNRES_STEP = 0.05f; // render scales are quantized to this step to avoid reallocating on every small change
+
+class DynamicResolution {
+public:
+    float Scale; // current render scale
+    float MinScale;
+    float MaxScale;
+    float TargetFrameTime; // GPU time budget of a frame in seconds
+    float GPUFrameTime; // smoothed measured GPU time of a frame in seconds
+    
+    DynamicResolution(float targetFrameRate, float scale, float minScale, float maxScale);
+    ~DynamicResolution();
+    
+    void BeginFrame();
+    bool EndFrame();
+    
+private:
+    unsigned int Queries[DYNRES_QUERY_FRAMES][2]; // start and end timestamps of the last few frames
+    unsigned int Frame; // number of frames measured so far
+    unsigned int FramesSinceChange;
+};
+
+#endif /* dynamic_resolution_hpp */
@@ -0,0 +1,79 @@
+/*
+ frame_arena.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the FrameArena class
+ A bump allocator for data that only lives until the end of the frame, such as formatted text.
+ */
+
+#include "frame_arena.hpp"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+FrameArena::FrameArena(size_t capacity) : Capacity(capacity), Used(0), Peak(0), Overflows(0), Buffer(new char[capacity]), Cursor(0) {
+    Spills.reserve(16);
+}
+
+FrameArena::~FrameArena() {
+    for (char *spill : Spills) {
+        delete[] spill;
+    }
+    delete[] Buffer;
+}
+
+// Returns memory valid until the next Reset. alignment must be a power of two.
+void *FrameArena::Allocate(size_t size, size_t alignment) {
+    uintptr_t base = (uintptr_t)Buffer;
+    uintptr_t aligned = (base + Cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    size_t end = aligned - base + size;
+    Used += size;
+    if (end <= Capacity) {
+        Cursor = end;
+        return (void*)aligned;
+    }
+    // the buffer is full. new[] aligns to alignof(std::max_align_t), more is not needed by anything in the game
+    char *spill = new char[size ? size : 1];
+    Spills.push_back(spill);
+    return spill;
+}
+
+// Formats text like printf into the arena and returns it
+const char *FrameArena::Format(const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    va_list copy;
+    va_copy(copy, arguments);
+    int length = vsnprintf(nullptr, 0, format, copy);
+    va_end(copy);
+    if (length < 0) {
+        va_end(arguments);
+        return "";
+    }
+    char *text = Allocate<char>(length + 1);
+    vsnprintf(text, length + 1, format, arguments);
+    va_end(arguments);
+    return text;
+}
+
+// Releases everything allocated since the last reset. Called at the start of each frame.
+// After a frame that spilled, the buffer is replaced by one that fits the frame's peak.
+void FrameArena::Reset() {
+    if (Used > Peak) {
+        Peak = Used;
+    }
+    if (!Spills.empty()) {
+        for (char *spill : Spills) {
+            delete[] spill;
+        }
+        Spills.clear();
+        Overflows++;
+        Capacity = Peak * 2;
+        delete[] Buffer;
+        Buffer = new char[Capacity];
+    }
+    Cursor = 0;
+    Used = 0;
+}
@@ -0,0 +1,45 @@
+/*
+ frame_arena.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the FrameArena class
+ A bump allocator for data that only lives until the end of the frame, such as formatted text.
+ */
+
+#ifndef frame_arena_hpp
+#define frame_arena_hpp
+
+#include <cstddef>
+#include <vector>
+
+const size_t FRAME_ARENA_CAPACITY = 64 * 1024; // initial bytes available to each frame
+
+// Allocations bump a cursor through one block and are all released at once by Reset. Nothing is destructed, so only
+// trivially destructible data may be allocated. A frame that does not fit spills into blocks of its own, which Reset frees,
+// and the arena grows to the frame's peak, so that later frames fit again without allocating.
+class FrameArena {
+public:
+    size_t Capacity; // bytes that fit before spilling
+    size_t Used; // bytes allocated in the current frame
+    size_t Peak; // most bytes allocated in a single frame
+    unsigned long long Overflows; // frames that spilled
+    
+    FrameArena(size_t capacity = FRAME_ARENA_CAPACITY);
+    ~FrameArena();
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+    
+    void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    template <typename T>
+    T *Allocate(size_t count) { return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T))); }
+    const char *Format(const char *format, ...);
+    void Reset();
+    
+private:
+    char *Buffer;
+    size_t Cursor; // next free byte of the buffer
+    std::vector<char*> Spills; // blocks allocated after the buffer filled up
+};
+
+#endif /* frame_arena_hpp */
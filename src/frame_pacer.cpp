@@ -0,0 +1,99 @@
+/*
+ frame_pacer.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the FramePacer class
+ A singleton that selects how frames are presented, limits the frame rate and collects frame-time statistics.
+ */
+
+#include "frame_pacer.hpp"
+#include "gl_state.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+FramePacer::FramePacer(PresentMode mode, float frameRateLimit, bool reportStats) : Mode(mode), FrameInterval(frameRateLimit > 0.0f ? 1.0 / frameRateLimit : 0.0), ReportStats(reportStats), Deadline(0.0), LastPresent(0.0), Idled(false), LastInputTime(0.0), LastReport(0.0) {}
+
+// Sets the swap interval of the current context. The limiter does its own pacing, so it presents without vsync.
+void FramePacer::Apply() {
+    glfwSwapInterval(Mode == PRESENT_VSYNC ? 1 : 0);
+    Deadline = LastPresent = LastReport = glfwGetTime();
+}
+
+// Waits until the next frame may start. Only waits under PRESENT_LIMITED.
+// Sleeping alone overshoots by up to a scheduler tick, so the last moments before the deadline are spent spinning
+void FramePacer::WaitForFrame() {
+    if (Mode != PRESENT_LIMITED) {
+        return;
+    }
+    double now = glfwGetTime();
+    while (Deadline - now > PACER_SPIN_MARGIN) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(Deadline - now - PACER_SPIN_MARGIN));
+        now = glfwGetTime();
+    }
+    while (now < Deadline) {
+        now = glfwGetTime();
+    }
+    // deadlines advance by whole intervals so that the rate does not drift, but a frame that ran late does not cause a burst
+    Deadline += FrameInterval;
+    if (Deadline < now) {
+        Deadline = now + FrameInterval;
+    }
+}
+
+// Records the time of a frame. Called right after the buffers are swapped.
+// inputTime is when the latest input reflected in the frame was received, used to measure input-to-present latency
+void FramePacer::EndFrame(double inputTime) {
+    if (!ReportStats) {
+        return;
+    }
+    double now = glfwGetTime();
+    if (!Idled) {
+        FrameTimes.push_back(now - LastPresent);
+    }
+    Idled = false;
+    LastPresent = now;
+    if (inputTime > LastInputTime) {
+        Latencies.push_back(now - inputTime);
+        LastInputTime = inputTime;
+    }
+    if (now - LastReport >= PACER_REPORT_INTERVAL) {
+        Report();
+        LastReport = now;
+    }
+}
+
+// Marks that the loop waited for events instead of rendering, so that the wait is not recorded as the next frame's time
+void FramePacer::Idle() {
+    Idled = true;
+}
+
+// Prints the statistics collected since the last report and starts over
+void FramePacer::Report() {
+    if (FrameTimes.empty()) {
+        return;
+    }
+    double total = 0.0;
+    for (double frameTime : FrameTimes) {
+        total += frameTime;
+    }
+    double average = total / FrameTimes.size();
+    std::cout << "Frames: " << FrameTimes.size() << ", " << 1.0 / average << " fps, frame time avg " << average * 1000.0 << " ms, p99 " << Percentile(FrameTimes, 0.99) * 1000.0 << " ms, max " << Percentile(FrameTimes, 1.0) * 1000.0 << " ms" << std::endl;
+    if (!Latencies.empty()) {
+        std::cout << "Input to present: " << Latencies.size() << " inputs, p50 " << Percentile(Latencies, 0.5) * 1000.0 << " ms, max " << Percentile(Latencies, 1.0) * 1000.0 << " ms" << std::endl;
+    }
+    std::cout << "GL state changes per frame: " << GLState::Stats.Issued / FrameTimes.size() << " issued, " << GLState::Stats.Skipped / FrameTimes.size() << " skipped" << std::endl;
+    GLState::Stats = GLStateStats();
+    FrameTimes.clear();
+    Latencies.clear();
+}
+
+// Returns the sample below which the given fraction of samples lie. Reorders the samples.
+double Percentile(std::vector<double> &samples, double fraction) {
+    size_t index = std::min(samples.size() - 1, (size_t)(fraction * (samples.size() - 1) + 0.5));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
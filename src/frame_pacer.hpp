@@ -0,0 +1,54 @@
+/*
+ frame_pacer.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the FramePacer class
+ A singleton that selects how frames are presented, limits the frame rate and collects frame-time statistics.
+ */
+
+#ifndef frame_pacer_hpp
+#define frame_pacer_hpp
+
+#include <glad/glad.h>
+#include <GLFW/GLFW3.H>
+
+#include <vector>
+
+const double PACER_SPIN_MARGIN = 0.002; // seconds before a frame deadline at which the limiter stops sleeping and spins
+const double PACER_REPORT_INTERVAL = 5.0; // seconds between two frame-time reports
+
+enum PresentMode {
+    PRESENT_VSYNC, // waits for the display's vertical blank
+    PRESENT_UNCAPPED, // presents as fast as frames are rendered
+    PRESENT_LIMITED // presents at a fixed rate, paced by sleeping and then spinning until each deadline
+};
+
+class FramePacer {
+public:
+    PresentMode Mode;
+    double FrameInterval; // seconds between two frames under PRESENT_LIMITED
+    bool ReportStats; // prints frame-time and latency statistics at regular intervals
+    
+    FramePacer(PresentMode mode, float frameRateLimit, bool reportStats);
+    
+    void Apply();
+    void WaitForFrame();
+    void EndFrame(double inputTime);
+    void Idle();
+    void Report();
+    
+private:
+    double Deadline; // when the next frame may start under PRESENT_LIMITED
+    double LastPresent;
+    bool Idled; // the loop slept waiting for events since the last present, so the next interval is not a frame time
+    double LastInputTime; // latest input whose latency has been recorded
+    double LastReport;
+    std::vector<double> FrameTimes; // present-to-present times since the last report
+    std::vector<double> Latencies; // input-to-present times since the last report
+};
+
+// Declaration of helper methods
+double Percentile(std::vector<double> &samples, double fraction);
+
+#endif /* frame_pacer_hpp */
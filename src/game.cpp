@@ -1,7 +1,7 @@
 /*
  game.cpp
  Breakout
- Last updated on October 5, 2020
+ Last updated on October 19, 2026
  
  Implementation of the Game class
  A singleton class that outlines and controls the life cycle of the game
@@ -15,12 +15,22 @@
 #include "particle_generator.hpp"
 #include "post_processor.hpp"
 #include "text_renderer.hpp"
+#include "scene_layer.hpp"
+#include "dynamic_resolution.hpp"
+#include "asset_loader.hpp"
+#include "triple_buffer.hpp"
+#include "render_queue.hpp"
+#include "stream_buffer.hpp"
+#include "profiler.hpp"
+#include "metrics.hpp"
+#include "frame_arena.hpp"
 
 #include <glm/glm.hpp>
-#include <irrKlang/irrKlang.h>
 
 #include <string>
 #include <algorithm>
+#include <cmath>
+#include <chrono>
 #include <iostream>
 
 // Declaration of singleton objects
@@ -29,75 +39,170 @@ GameObject *paddle;
 Ball *ball;
 ParticleGenerator *particles;
 PostProcessor *effects;
-irrklang::ISoundEngine *sound;
+AudioEngine *audio;
 TextRenderer *text;
+SceneLayer *sceneLayer;
+DynamicResolution *dynamicRes; // only created if a target frame rate is set
+AssetLoader *loader; // only exists while assets are loading
+std::vector<GlyphBitmap> preloadedGlyphs; // glyphs rasterized by the loader, handed to the text renderer once it exists
+Texture2D powerUpTextures[NUM_POWERUP_TYPES]; // looked up once, so that frames do not search the resource manager
+Texture2D backgroundTexture; // looked up once, so that frames do not search the resource manager
+Shader brickShader; // looked up once as well
+TripleBuffer<RenderSnapshot> *snapshots; // passes the state of each simulation step to the render thread
+RenderQueue *renderQueue; // draws of the current render pass, submitted sorted by render state
+StreamBuffer *streamBuffer; // vertices and instances rewritten every frame
+FrameArena *frameArena; // transient data of the current frame, such as formatted text
+
+// Render thread's copies of the levels, which own the instance buffers. Only the destroyed blocks are taken from snapshots.
+std::vector<GameLevel> renderLevels;
+unsigned int renderedLevel = 0;
+unsigned int renderedLevelVersion = 0;
+
+// Font settings and the characters whose glyphs are rasterized while loading
+const char *FONT_PATH = "fonts/OCRAEXT.TTF";
+const unsigned int FONT_SIZE = 48;
+const char *PRELOADED_TEXT = "Lives: 0123456789 Press ENTER to start W or S select level You WON!!! retry ESC quit";
+const char *MUSIC_PATH = "audio/breakout.mp3";
+const char *EVENT_SOUNDS[NUM_GAME_EVENT_TYPES] = {"audio/bleep.mp3", "audio/solid.wav", "audio/bleep.wav", "audio/powerup.wav", nullptr}; // sound of each type of gameplay event, if any
+unsigned int music = AUDIO_NO_SOUND;
+unsigned int eventSounds[NUM_GAME_EVENT_TYPES]; // ids of the loaded event sounds
+const double LOADING_UPLOAD_BUDGET = 0.008; // seconds per frame spent uploading loaded assets
+const double MAX_SIMULATION_LAG = 0.1; // seconds the simulation may fall behind before it skips steps
+const double IDLE_INPUT_GRACE = 0.25; // seconds rendered at full rate after input, until the simulation has applied it
+const double IDLE_ANIMATION_RATE = 30.0; // frame rate of animated post-processing effects while idle
+const double IDLE_REDRAW_INTERVAL = 1.0; // seconds between frames while idle and nothing is animated
 
 // Declaration of helper methods
-Direction ClosestDir(glm::vec2 target);
-bool CheckCollisions(GameObject &a, GameObject &b);
-CollisionRes CheckCollisions(Ball &ball, GameObject &block);
-bool RollDice(unsigned int chance);
+unsigned long long StepsUntil(float seconds);
 
 // Game creation
-Game::Game(unsigned int width, unsigned int height) : State(GAME_MENU), Keys(), Width(width), Height(height), CurLevel(0), Lives(3) {
+Game::Game(unsigned int width, unsigned int height) : State(GAME_MENU), Keys(), Width(width), Height(height), FramebufferWidth(width), FramebufferHeight(height), CurLevel(0), Lives(3), FrameInputTime(0.0), BricksDestroyed(0), Timers(POWERUP_POOL_CAPACITY + 1), ActivePowerUps(), BallStuckTime(0.0f), Chaos(false), Confuse(false), Shake(false), LevelVersion(0), Random(), SimulationRunning(false), ResizePending(false), SimulationTime(0.0), LastInputTime(0.0), WindowInputTime(0.0), LatchKeys(), RenderedState(GAME_LOADING), LastFrameTime(0.0), RedrawRequested(true) {
     memset(Keys, false, sizeof(Keys));
     memset(KeysProcessed, false, sizeof(KeysProcessed));
 }
 
 // Resource cleanup
 Game::~Game() {
+    StopSimulation();
+    delete snapshots;
+    delete renderQueue;
+    delete streamBuffer;
+    delete frameArena;
     delete renderer;
     delete paddle;
     delete ball;
     delete particles;
     delete effects;
     delete text;
-    sound->drop();
+    delete sceneLayer;
+    delete dynamicRes;
+    delete loader;
+    delete audio;
 }
 
 // Game initialization
+// Shader sources, images and glyphs are prepared on worker threads while the window shows a loading bar
 void Game::Init() {
-    // load and configure shaders
-    Shader shaderSprite = ResourceManager::LoadShader("shaders/sprite.vert", "shaders/sprite.frag", nullptr, "shaderSprite"); // game object shader
-    Shader shaderParticle = ResourceManager::LoadShader("shaders/particle.vert", "shaders/particle.frag", nullptr, "shaderParticle"); // particle shader
-    Shader shaderPP = ResourceManager::LoadShader("shaders/post_processing.vert", "shaders/post_processing.frag", nullptr, "shaderPP"); // post-processing shader
+    State = GAME_LOADING;
+    loader = new AssetLoader();
+    
+    // shaders are read on the workers and compiled on this thread
+    ResourceManager::LoadShaderAsync(*loader, "shaders/sprite.vert", "shaders/sprite.frag", nullptr, "shaderSprite"); // game object shader
+    ResourceManager::LoadShaderAsync(*loader, "shaders/particle.vert", "shaders/particle.frag", nullptr, "shaderParticle"); // particle shader
+    ResourceManager::LoadShaderAsync(*loader, "shaders/brick.vert", "shaders/brick.frag", nullptr, "shaderBrick"); // instanced block shader
+    ResourceManager::LoadShaderAsync(*loader, "shaders/text.vert", "shaders/text.frag", nullptr, "text"); // text shader
+    for (unsigned int effects = 1; effects < PP_NUM_VARIANTS; effects++) {
+        // post-processing shader variants
+        ResourceManager::LoadShaderAsync(*loader, "shaders/post_processing.vert", "shaders/post_processing.frag", nullptr, PostProcessor::VariantName(effects), PostProcessor::VariantDefines(effects));
+    }
+    
+    // load textures
+    ResourceManager::LoadTextureAsync(*loader, "textures/block_solid.png", "block_solid", false);
+    ResourceManager::LoadTextureAsync(*loader, "textures/block_breakable.png", "block_breakable", false);
+    ResourceManager::LoadTextureAsync(*loader, "textures/background.jpg", "background", true);
+    ResourceManager::LoadTextureAsync(*loader, "textures/paddle.png", "paddle", false);
+    ResourceManager::LoadTextureAsync(*loader, "textures/ball.png", "ball", false);
+    ResourceManager::LoadTextureAsync(*loader, "textures/powerup_chaos.png", "tex_chaos", false);
+    ResourceManager::LoadTextureAsync(*loader, "textures/powerup_confuse.png", "tex_confuse", false);
+    ResourceManager::LoadTextureAsync(*loader, "textures/powerup_size.png", "tex_size", true);
+    ResourceManager::LoadTextureAsync(*loader, "textures/powerup_passthrough.png", "tex_pass", false);
+    ResourceManager::LoadTextureAsync(*loader, "textures/powerup_speed.png", "tex_speed", false);
+    ResourceManager::LoadTextureAsync(*loader, "textures/powerup_sticky.png", "tex_sticky", false);
+    ResourceManager::LoadTextureAsync(*loader, "textures/particle.png", "particle", false);
+    
+    // rasterize the glyphs of all texts shown by the game. Other glyphs are still rasterized lazily when first drawn.
+    loader->Enqueue([]() -> UploadTask {
+        std::vector<GlyphBitmap> glyphs = TextRenderer::RasterizeGlyphs(FONT_PATH, FONT_SIZE, PRELOADED_TEXT);
+        return [glyphs]() {
+            preloadedGlyphs = glyphs;
+        };
+    });
+}
+
+// Finishes initialization once all assets are loaded. Called from Render while loading.
+void Game::FinishInit() {
+    delete loader;
+    loader = nullptr;
     
+    // configure shaders
+    Shader shaderSprite = ResourceManager::GetShader("shaderSprite");
+    Shader shaderParticle = ResourceManager::GetShader("shaderParticle");
+    Shader shaderBrick = ResourceManager::GetShader("shaderBrick");
     glm::mat4 projection = glm::ortho(0.0f, (float)Width, (float)Height, 0.0f, -1.0f, 1.0f);
     shaderSprite.setInt("spriteTexture", 0);
     shaderSprite.setMat4("projection", projection);
     shaderParticle.setInt("sprite", 0);
     shaderParticle.setMat4("projection", projection);
-    
-    // load textures
-    ResourceManager::LoadTexture("textures/block_solid.png", "block_solid", false);
-    ResourceManager::LoadTexture("textures/block_breakable.png", "block_breakable", false);
-    ResourceManager::LoadTexture("textures/background.jpg", "background", true);
-    ResourceManager::LoadTexture("textures/paddle.png", "paddle", false);
-    ResourceManager::LoadTexture("textures/ball.png", "ball", false);
-    ResourceManager::LoadTexture("textures/powerup_chaos.png", "tex_chaos", false);
-    ResourceManager::LoadTexture("textures/powerup_confuse.png", "tex_confuse", false);
-    ResourceManager::LoadTexture("textures/powerup_size.png", "tex_size", true);
-    ResourceManager::LoadTexture("textures/powerup_passthrough.png", "tex_pass", false);
-    ResourceManager::LoadTexture("textures/powerup_speed.png", "tex_speed", false);
-    ResourceManager::LoadTexture("textures/powerup_sticky.png", "tex_sticky", false);
-    Texture2D textureParticle = ResourceManager::LoadTexture("textures/particle.png", "particle", false);
+    shaderBrick.setInt("solidTexture", 0);
+    shaderBrick.setInt("breakableTexture", 1);
+    shaderBrick.setMat4("projection", projection);
+    for (unsigned int i = 0; i < NUM_BLOCK_COLORS; i++) {
+        shaderBrick.setVec3(("colors[" + std::to_string(i) + "]").c_str(), BLOCK_COLORS[i]);
+    }
+    Texture2D textureParticle = ResourceManager::GetTexture("particle");
     
     // create singleton objects
     renderer = new SpriteRenderer(shaderSprite);
-    particles = new ParticleGenerator(shaderParticle, textureParticle, 500);
-    effects = new PostProcessor(shaderPP, Width, Height, true);
-    sound = irrklang::createIrrKlangDevice();
-    text = new TextRenderer(Width, Height);
-    text->Load("fonts/OCRAEXT.TTF", 48);
+    streamBuffer = new StreamBuffer();
+    renderQueue = new RenderQueue(*streamBuffer);
+    frameArena = new FrameArena();
+    particles = new ParticleGenerator(shaderParticle, textureParticle, 500, *streamBuffer);
+    effects = new PostProcessor(FramebufferWidth, FramebufferHeight, Settings.RenderScale, Settings.Samples); // uses the preloaded shader variants
+    if (Settings.TargetFrameRate > 0.0f) {
+        dynamicRes = new DynamicResolution(Settings.TargetFrameRate, Settings.RenderScale, Settings.MinRenderScale, Settings.RenderScale);
+    }
+    sceneLayer = new SceneLayer(effects->Width, effects->Height, Width, Height);
+    ResizePending = false; // the render targets were just created at the current size
+    // sounds are decoded once here, so playing them during the game never decodes or reads files
+    audio = new AudioEngine(AudioMode);
+    music = audio->Load(MUSIC_PATH, 1, 0.0f);
+    for (unsigned int type = 0; type < NUM_GAME_EVENT_TYPES; type++) {
+        eventSounds[type] = EVENT_SOUNDS[type] ? audio->Load(EVENT_SOUNDS[type]) : AUDIO_NO_SOUND;
+    }
+    audio->Start();
+    text = new TextRenderer(Width, Height, *streamBuffer);
+    text->Load(FONT_PATH, FONT_SIZE);
+    text->AddGlyphs(preloadedGlyphs);
+    preloadedGlyphs.clear();
     
     // load levels
     for (unsigned int i = 0; i < NUM_LEVELS; i++) {
         GameLevel level;
-        const char *path = ("levels/level"+std::to_string(i)+".txt").c_str();
-        level.Load(path, Width, Height / 2);
+        level.Load("levels/level"+std::to_string(i)+".txt", Width, Height / 2);
         Levels.push_back(level);
     }
     CurLevel = 0;
+    if (BenchmarkMode.Enabled) {
+        // a benchmark plays a single level, and everything random in the game follows its seed
+        srand(BenchmarkMode.Seed);
+        Random.seed(BenchmarkMode.Seed);
+        if (BenchmarkMode.Level == BENCHMARK_STRESS_LEVEL) {
+            Levels[0].Generate(15 * BenchmarkMode.StressScale, 8 * BenchmarkMode.StressScale, Width, Height / 2);
+        } else {
+            CurLevel = BenchmarkMode.Level;
+        }
+    }
+    renderLevels = Levels;
     
     // initialize paddle and ball
     glm::vec2 paddlePos = glm::vec2(Width / 2.0f - PADDLE_SIZE.x / 2.0f, Height - PADDLE_SIZE.y);
@@ -107,26 +212,140 @@ void Game::Init() {
     Texture2D ballTexture = ResourceManager::GetTexture("ball");
     ball = new Ball(ballPos, BALL_RADIUS, BALL_V0, ballTexture);
     
-    // play sound
-    sound->play2D("audio/breakout.mp3", true);
+    const char *powerUpTextureNames[NUM_POWERUP_TYPES] = {"tex_speed", "tex_sticky", "tex_pass", "tex_size", "tex_confuse", "tex_chaos"};
+    for (unsigned int i = 0; i < NUM_POWERUP_TYPES; i++) {
+        powerUpTextures[i] = ResourceManager::GetTexture(powerUpTextureNames[i]);
+    }
+    backgroundTexture = ResourceManager::GetTexture("background");
+    brickShader = shaderBrick;
+    ResourceManager::ReportTextureMemory();
+    
+    // play music
+    audio->Play(music, 1.0f, true);
+    State = GAME_MENU;
+    StartSimulation();
 }
 
-// Game state update. Called each frame after ProcessInput.
-void Game::Update(float dt) {
-    ball->Move(dt, Width); // move ball
-    EnforceCollisions(); // detect and resolve collisions
-    particles->Update(dt, *ball, 2, glm::vec2(ball->Radius / 2.0f)); // update particles
-    UpdatePowerUps(dt); // update powerup effects
-    if (ShakeTime > 0.0f) {
-        // controls shake effect
-        ShakeTime -= dt;
-        if (ShakeTime < 0.0f) {
-            effects->Shake = false;
+// Starts stepping the simulation on its own thread. Called once loading has finished.
+void Game::StartSimulation() {
+    snapshots = new TripleBuffer<RenderSnapshot>(RenderSnapshot(*paddle, *ball));
+    SimulationTime = glfwGetTime();
+    PublishSnapshot();
+    if (BenchmarkMode.Enabled) {
+        return; // the benchmark steps the simulation itself
+    }
+    SimulationRunning = true;
+    SimulationThread = std::thread(&Game::RunSimulation, this);
+}
+
+// Stops the simulation thread after its current step. Must be called before the window is destroyed.
+void Game::StopSimulation() {
+    SimulationRunning = false;
+    if (SimulationThread.joinable()) {
+        SimulationThread.join();
+    }
+}
+
+// Steps the simulation at a fixed rate until stopped, publishing a snapshot after each step
+// Runs on its own thread, so a slow frame or a blocking buffer swap does not delay the simulation
+// A step is simulated once its time span has passed, so all key events within the span are known
+void Game::RunSimulation() {
+    Profiler::SetThreadName("Simulation");
+    const double step = 1.0 / SIMULATION_RATE;
+    double stepStart = glfwGetTime();
+    while (SimulationRunning.load(std::memory_order_acquire)) {
+        double now = glfwGetTime();
+        if (now < stepStart + step) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(stepStart + step - now));
+            continue;
         }
+        if (now - stepStart > MAX_SIMULATION_LAG) {
+            // after a long stall, the missed steps are dropped instead of being run back to back
+            stepStart = now - step;
+        }
+        ProcessInput(stepStart, (float)step);
+        Update((float)step);
+        stepStart += step;
+        SimulationTime = stepStart;
+        PublishSnapshot();
+    }
+}
+
+// Runs a simulation step on the calling thread with the autopilot at the controls. Called by the benchmark instead of the simulation thread.
+// Steps are timed by their index rather than the clock, so the course of a benchmark only depends on its seed
+void Game::StepBenchmark(unsigned int tick) {
+    const double step = 1.0 / SIMULATION_RATE;
+    double stepStart = tick * step;
+    DriveAutopilot(stepStart);
+    ProcessInput(stepStart, (float)step);
+    Update((float)step);
+    SimulationTime = stepStart + step;
+    PublishSnapshot();
+}
+
+// Queues a key press or release for the simulation, stamped with the time it was received. Called on the window thread.
+// The paddle keys are also tracked on the window thread for the late latch
+void Game::QueueKeyEvent(int key, int action) {
+    if (key < 0 || key >= 1024 || action == GLFW_REPEAT) {
+        return;
     }
+    double time = glfwGetTime();
+    KeyEvents.Push({key, action, time});
+    WindowInputTime = time;
+    if (key == GLFW_KEY_A || key == GLFW_KEY_D) {
+        LatchKeys[key == GLFW_KEY_A ? 0 : 1].Record(action == GLFW_PRESS, time);
+    }
+}
+
+// Copies the state drawn by the render thread into the next snapshot and publishes it
+// The snapshot's vectors keep their capacity between steps, so publishing rarely allocates
+void Game::PublishSnapshot() {
+    PROFILE_ZONE("Publish snapshot");
+    RenderSnapshot &snapshot = snapshots->Write();
+    snapshot.State = State;
+    snapshot.Time = SimulationTime;
+    snapshot.InputTime = LastInputTime;
+    snapshot.CurLevel = CurLevel;
+    snapshot.LevelVersion = LevelVersion;
+    snapshot.Lives = Lives;
+    const std::vector<GameObject> &bricks = Levels[CurLevel].Bricks;
+    snapshot.DestroyedBricks.resize(bricks.size());
+    for (unsigned int i = 0; i < bricks.size(); i++) {
+        snapshot.DestroyedBricks[i] = bricks[i].Destroyed;
+    }
+    snapshot.PaddleState = *paddle;
+    snapshot.BallState = *ball;
+    if (snapshot.PowerUps.capacity() < POWERUP_POOL_CAPACITY) {
+        snapshot.PowerUps.reserve(POWERUP_POOL_CAPACITY); // happens once for each of the three snapshots
+    }
+    snapshot.PowerUps.clear();
+    for (unsigned int slot : PowerUps.Falling()) {
+        snapshot.PowerUps.push_back(PowerUps.Slot(slot));
+    }
+    snapshot.Chaos = Chaos;
+    snapshot.Confuse = Confuse;
+    snapshot.Shake = Shake;
+    snapshots->Publish();
+}
+
+// Resizes the offscreen render targets to follow the window. Called when the window's framebuffer size changes.
+// The render targets are resized at the start of the next frame, as events may also be polled in the middle of a frame
+void Game::Resize(unsigned int framebufferWidth, unsigned int framebufferHeight) {
+    FramebufferWidth = framebufferWidth;
+    FramebufferHeight = framebufferHeight;
+    ResizePending = true;
+}
+
+// Game state update. Called on the simulation thread after ProcessInput in every step.
+void Game::Update(float dt) {
+    PROFILE_ZONE("Update");
+    ball->Move(dt - BallStuckTime, Width); // move ball for the part of the step it was not stuck on the paddle
+    EnforceCollisions(); // detect and resolve collisions
+    UpdatePowerUps(dt); // move falling powerups
     if (ball->Position.y > Height) {
         // player loses a life if ball reaches bottom of screen
         Lives--;
+        Events.Emit(GAME_EVENT_LIFE_LOST, ball->Position, Lives);
         ResetPlayer();
         // reset game if all lives lost
         if (Lives == 0) {
@@ -140,13 +359,71 @@ void Game::Update(float dt) {
         ClearPowerUps();
         ResetLevel();
         ResetPlayer();
-        effects->Chaos = true;
+        Chaos = true;
         State = GAME_WIN;
     }
+    HandleEvents(); // sounds, shakes, powerup spawns and counters of the step's events
+    Timers.Advance([this](TimerEvent event) { ExpireTimer(event); }); // end the effects that run out in this step
 }
 
-// Update game state based on keyboard input.
-void Game::ProcessInput(float dt) {
+// Handles the gameplay events of the step in a batch, once its collisions are resolved
+// Simultaneous events are merged where that looks and sounds the same, e.g. each sound is played once per step
+void Game::HandleEvents() {
+    bool emitted[NUM_GAME_EVENT_TYPES] = {};
+    for (const GameEvent &event : Events) {
+        emitted[event.Type] = true;
+        if (event.Type == GAME_EVENT_BRICK_DESTROYED) {
+            BricksDestroyed++;
+            if (State == GAME_ACTIVE) {
+                SpawnPowerUps(event.Position); // a step that ended the game has already discarded its powerups
+            }
+        }
+    }
+    if (emitted[GAME_EVENT_SOLID_HIT]) {
+        // when the ball hits solid blocks, a short shake effect is introduced
+        Timers.Cancel(ShakeTimer);
+        ShakeTimer = Timers.Schedule(StepsUntil(SHAKE_DURATION), {TIMER_SHAKE_END, 0});
+        Shake = true;
+    }
+    for (unsigned int type = 0; type < NUM_GAME_EVENT_TYPES; type++) {
+        if (emitted[type]) {
+            audio->Play(eventSounds[type]); // queued for the mixer thread, unknown sounds are ignored
+        }
+    }
+    METRIC_ADD(METRIC_GAME_EVENTS, Events.Size());
+    Events.Clear();
+}
+
+// Applies the key events of a simulation step at the times they happened
+// The paddle moves with the keys held between events, so presses and releases take effect within the step rather than at its start
+void Game::ProcessInput(double stepStart, float dt) {
+    PROFILE_ZONE("Input");
+    double stepEnd = stepStart + dt;
+    double time = stepStart;
+    BallStuckTime = ball->Stuck ? dt : 0.0f;
+    ProcessKeyActions(0.0f);
+    KeyEvent event;
+    while (KeyEvents.Peek(event) && event.Time <= stepEnd) {
+        KeyEvents.Pop(event);
+        LastInputTime = event.Time;
+        // events received before the step, e.g. while the simulation was stalled, are applied at its start
+        double eventTime = std::max(event.Time, stepStart);
+        MovePaddle((float)(eventTime - time));
+        time = eventTime;
+        if (event.Action == GLFW_PRESS) {
+            Keys[event.Key] = true;
+        } else if (event.Action == GLFW_RELEASE) {
+            Keys[event.Key] = false;
+            KeysProcessed[event.Key] = false;
+        }
+        ProcessKeyActions((float)(eventTime - stepStart));
+    }
+    MovePaddle((float)(stepEnd - time));
+}
+
+// Triggers the actions of pressed keys. Called at the start of a step and after every key event.
+// offset is the time since the start of the step
+void Game::ProcessKeyActions(float offset) {
     if (State == GAME_MENU) {
         // player makes level selection
         if (Keys[GLFW_KEY_ENTER] && !KeysProcessed[GLFW_KEY_ENTER]) {
@@ -165,61 +442,263 @@ void Game::ProcessInput(float dt) {
         // player may choose to reset game after winning
         State = GAME_MENU;
         KeysProcessed[GLFW_KEY_ENTER] = true;
-        effects->Chaos = false;
-    } else if (State == GAME_ACTIVE) {
-        // play uses keyboard to control paddle and release ball
-        float deltaDist = PADDLE_VELOCITY * dt;
-        if (Keys[GLFW_KEY_A] && paddle->Position.x - deltaDist >= 0.0f) {
-            paddle->Position.x -= deltaDist;
-            if (ball->Stuck) {
-                ball->Position.x -= deltaDist;
-            }
-        } else if (Keys[GLFW_KEY_D] && paddle->Position.x + deltaDist <= Width - paddle->Size.x) {
-            paddle->Position.x += deltaDist;
-            if (ball->Stuck) {
-                ball->Position.x += deltaDist;
-            }
-        }
-        if (Keys[GLFW_KEY_SPACE]) {
-            ball->Stuck = false;
-        }
+        Chaos = false;
+    } else if (State == GAME_ACTIVE && Keys[GLFW_KEY_SPACE] && ball->Stuck) {
+        // the ball only travels for the rest of the step after its release
+        ball->Stuck = false;
+        BallStuckTime = offset;
     }
 }
 
-// Renders the game. Called each frame after Update.
-void Game::Render() {
-    // scene is first rendered to the post processor's framebuffer
-    effects->BeginRender();
-        
-    Texture2D background = ResourceManager::GetTexture("background");
-    renderer->DrawSprite(background, glm::vec2(0.0f, 0.0f), glm::vec2(Width, Height), 0.0f, glm::vec3(1.0f));
-    Levels[CurLevel].Draw(*renderer);
-    paddle->Draw(*renderer);
-    for (PowerUp &powerUp : PowerUps) {
-        if (!powerUp.Destroyed) {
-            powerUp.Draw(*renderer);
+// Presses the keys a player would: starts the game from the menu and the win screen, releases the ball and keeps the paddle under it
+// The paddle aims to hit the ball off its center by an amount that changes with every destroyed block, so the ball does not fall into a loop
+void Game::DriveAutopilot(double time) {
+    bool menu = State == GAME_MENU || State == GAME_WIN;
+    SetAutopilotKey(GLFW_KEY_ENTER, menu && !Keys[GLFW_KEY_ENTER], time); // released in between, as each press only counts once
+    bool active = State == GAME_ACTIVE;
+    SetAutopilotKey(GLFW_KEY_SPACE, active && ball->Stuck, time);
+    float aim = ball->Position.x + ball->Radius + paddle->Size.x * 0.3f * ((int)(BricksDestroyed % 3) - 1);
+    float paddleCenter = paddle->Position.x + paddle->Size.x * 0.5f;
+    bool moveLeft = active && !ball->Stuck && paddleCenter > aim + ball->Radius * 0.5f;
+    bool moveRight = active && !ball->Stuck && paddleCenter < aim - ball->Radius * 0.5f;
+    SetAutopilotKey(GLFW_KEY_A, moveLeft, time);
+    SetAutopilotKey(GLFW_KEY_D, moveRight, time);
+}
+
+// Queues an event for a key whose state differs from what the autopilot wants
+void Game::SetAutopilotKey(int key, bool held, double time) {
+    if (Keys[key] != held) {
+        KeyEvents.Push({key, held ? GLFW_PRESS : GLFW_RELEASE, time});
+    }
+}
+
+// Moves the paddle, and the ball stuck on it, as the held keys direct over a span of time
+void Game::MovePaddle(float dt) {
+    if (State != GAME_ACTIVE || dt <= 0.0f) {
+        return;
+    }
+    float deltaDist = 0.0f;
+    if (Keys[GLFW_KEY_A]) {
+        deltaDist = std::max(-PADDLE_VELOCITY * dt, -paddle->Position.x);
+    } else if (Keys[GLFW_KEY_D]) {
+        deltaDist = std::min(PADDLE_VELOCITY * dt, Width - paddle->Size.x - paddle->Position.x);
+    }
+    paddle->Position.x += deltaDist;
+    if (ball->Stuck) {
+        ball->Position.x += deltaDist;
+    }
+}
+
+// Decides whether a frame should be rendered now. Called on the window thread before each frame.
+// Loading and active gameplay always render. The menu and the win screen are idle: they render after input, after a resize
+// or when the window asks for a redraw, and otherwise only as often as their animated effects need.
+// If no frame is due, timeout is set to the seconds until the next one, to be spent waiting for events.
+bool Game::FrameDue(double &timeout) {
+    timeout = 0.0;
+    if (loader || !snapshots) {
+        return true;
+    }
+    snapshots->Acquire();
+    const RenderSnapshot &snapshot = snapshots->Read();
+    double now = glfwGetTime();
+    if (snapshot.State == GAME_ACTIVE || snapshot.State != RenderedState || ResizePending || RedrawRequested || now - WindowInputTime < IDLE_INPUT_GRACE) {
+        return true;
+    }
+    double interval = (snapshot.Chaos || snapshot.Shake) ? 1.0 / IDLE_ANIMATION_RATE : IDLE_REDRAW_INTERVAL;
+    timeout = LastFrameTime + interval - now;
+    return timeout <= 0.0;
+}
+
+// Asks for a frame while the game is idle, e.g. when the window's contents were damaged. Called on the window thread.
+void Game::RequestRedraw() {
+    RedrawRequested = true;
+}
+
+// Renders the latest simulation snapshot. Called each frame on the thread owning the OpenGL context.
+void Game::Render(float dt) {
+    if (loader) {
+        // uploads finished assets within a time budget so that the loading screen stays responsive
+        // shaders are submitted as their sources arrive and built by the driver in parallel, and stored once built
+        bool uploaded = loader->Poll(LOADING_UPLOAD_BUDGET);
+        bool compiled = ResourceManager::FinishShaders();
+        if (!uploaded || !compiled) {
+            RenderLoadingScreen();
+            return;
         }
+        FinishInit();
+    }
+    if (ResizePending) {
+        glViewport(0, 0, FramebufferWidth, FramebufferHeight);
+        effects->Resize(FramebufferWidth, FramebufferHeight);
+        sceneLayer->Resize(effects->Width, effects->Height);
+        ResizePending = false;
+    }
+    Profiler::BeginFrame();
+    PROFILE_ZONE("Render");
+    streamBuffer->BeginFrame();
+    frameArena->Reset();
+    snapshots->Acquire();
+    const RenderSnapshot &snapshot = snapshots->Read();
+    FrameInputTime = snapshot.InputTime;
+    RenderedState = snapshot.State;
+    LastFrameTime = glfwGetTime();
+    RedrawRequested = false;
+    SyncLevel(snapshot);
+    effects->Chaos = snapshot.Chaos;
+    effects->Confuse = snapshot.Confuse;
+    effects->Shake = snapshot.Shake;
+    particles->Update(dt, snapshot.BallState, 2, glm::vec2(snapshot.BallState.Radius / 2.0f)); // particles are purely visual and follow the frame rate
+    if (dynamicRes) {
+        dynamicRes->BeginFrame();
     }
-    particles->Render();
-    ball->Draw(*renderer);
-    text->RenderText("Lives: " + std::to_string(Lives), 5.0f, 5.0f, 0.5f);
     
+    // background and bricks are cached in a layer which is only redrawn where bricks were destroyed
+    sceneLayer->Update(*renderer, brickShader, backgroundTexture, renderLevels[snapshot.CurLevel]);
+    
+    // the scene is recorded in the render queue, whose layers keep the drawing order, and submitted to the post processor's framebuffer
+    sceneLayer->Draw(*renderer, *renderQueue);
+    for (const PowerUp &powerUp : snapshot.PowerUps) {
+        renderer->QueueSprite(*renderQueue, LAYER_OBJECTS, powerUpTextures[powerUp.Type], powerUp.Position, POWERUP_SIZE, 0.0f, POWERUP_COLORS[powerUp.Type]);
+    }
+    particles->Render(*renderQueue);
+    // the paddle and the ball are recorded last, so that a late latch samples input as close to the swap as possible
+    // their layers still draw the paddle under the powerups and the ball over the particles
+    GameObject paddleState = snapshot.PaddleState;
+    Ball ballState = snapshot.BallState;
+    if (Settings.LateLatch && snapshot.State == GAME_ACTIVE) {
+        LatchPaddle(snapshot, paddleState, ballState);
+    }
+    paddleState.Draw(*renderer, *renderQueue, LAYER_PADDLE);
+    ballState.Draw(*renderer, *renderQueue, LAYER_BALL);
+    text->RenderText(frameArena->Format("Lives: %u", snapshot.Lives), 5.0f, 5.0f, 0.5f);
+    text->Flush(*renderQueue);
+    effects->BeginRender();
+    renderQueue->Submit();
     effects->EndRender();
     
-    // scene is rendered to screen after post processing is done
+    // scene is rendered to screen after post processing is done, the menu text on top of it
     effects->RenderToScreen(glfwGetTime());
-    if (State == GAME_MENU) {
+    if (snapshot.State == GAME_MENU) {
         text->RenderText("Press ENTER to start", 250.0f, Height / 2.0f - 20.0f, 0.5f);
         text->RenderText("Press W or S to select level", 235.0f, Height / 2.0f + 20.0f, 0.4f);
-    } else if (State == GAME_WIN) {
+    } else if (snapshot.State == GAME_WIN) {
         text->RenderText("You WON!!!", 320.0f, Height / 2.0f - 20.0f, 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
         text->RenderText("Press ENTER to retry or ESC to quit", 130.0f, Height / 2.0f + 20.0f, 0.5f, glm::vec3(1.0f, 1.0f, 0.0f));
     }
+    if (Profiler::Overlay) {
+        Profiler::DrawOverlay(*text);
+    }
+    text->Flush(*renderQueue);
+    renderQueue->Submit();
+    
+    streamBuffer->EndFrame();
+    
+    // the dynamic resolution controller may lower or raise the resolution of the next frames
+    if (dynamicRes && dynamicRes->EndFrame()) {
+        effects->SetRenderScale(dynamicRes->Scale);
+        sceneLayer->Resize(effects->Width, effects->Height);
+    }
+}
+
+// Moves the drawn paddle, and the ball stuck on it, by the input received since the snapshot's step
+// The span is split at every press and release, and each part moves the paddle like MovePaddle does, A before D
+// The simulation catches up with the same input in its next steps, so the latched position is only shown for a frame or two
+void Game::LatchPaddle(const RenderSnapshot &snapshot, GameObject &paddleState, Ball &ballState) {
+    glfwPollEvents();
+    double now = glfwGetTime();
+    double times[2 * LATCH_TRANSITIONS + 2];
+    unsigned int numTimes = 0;
+    times[numTimes++] = snapshot.Time;
+    for (const LatchKey &latchKey : LatchKeys) {
+        for (unsigned int i = latchKey.Count > LATCH_TRANSITIONS ? latchKey.Count - LATCH_TRANSITIONS : 0; i < latchKey.Count; i++) {
+            double time = latchKey.Transitions[i % LATCH_TRANSITIONS].Time;
+            if (time > snapshot.Time && time < now) {
+                times[numTimes++] = time;
+            }
+        }
+    }
+    times[numTimes++] = now;
+    std::sort(times, times + numTimes);
+    float deltaDist = 0.0f;
+    for (unsigned int i = 0; i + 1 < numTimes; i++) {
+        float span = (float)(times[i + 1] - times[i]);
+        if (LatchKeys[0].HeldAt(times[i])) {
+            deltaDist -= PADDLE_VELOCITY * span;
+        } else if (LatchKeys[1].HeldAt(times[i])) {
+            deltaDist += PADDLE_VELOCITY * span;
+        }
+    }
+    deltaDist = std::min(std::max(deltaDist, -paddleState.Position.x), Width - paddleState.Size.x - paddleState.Position.x);
+    paddleState.Position.x += deltaDist;
+    if (ballState.Stuck) {
+        ballState.Position.x += deltaDist;
+    }
+    if (WindowInputTime > snapshot.Time) {
+        FrameInputTime = WindowInputTime;
+    }
+}
+
+// Remembers a press or release, replacing the oldest remembered one
+void LatchKey::Record(bool held, double time) {
+    Transitions[Count++ % LATCH_TRANSITIONS] = {time, held};
+}
+
+// Returns whether the key was held at a point in time, as far as the remembered transitions tell
+// Before the oldest remembered transition, the key was in the opposite state
+bool LatchKey::HeldAt(double time) const {
+    unsigned int oldest = Count > LATCH_TRANSITIONS ? Count - LATCH_TRANSITIONS : 0;
+    for (unsigned int i = Count; i-- > oldest;) {
+        const KeyTransition &transition = Transitions[i % LATCH_TRANSITIONS];
+        if (transition.Time <= time) {
+            return transition.Held;
+        }
+    }
+    return Count > 0 && !Transitions[oldest % LATCH_TRANSITIONS].Held;
+}
+
+// Brings the render thread's copy of the current level up to date with a snapshot
+// The scene layer is redrawn where blocks were destroyed, or entirely when the level was switched or restored
+void Game::SyncLevel(const RenderSnapshot &snapshot) {
+    PROFILE_ZONE("Sync level");
+    GameLevel &level = renderLevels[snapshot.CurLevel];
+    if (snapshot.CurLevel != renderedLevel || snapshot.LevelVersion != renderedLevelVersion) {
+        level.Reset();
+        sceneLayer->Invalidate();
+        renderedLevel = snapshot.CurLevel;
+        renderedLevelVersion = snapshot.LevelVersion;
+    }
+    for (unsigned int i = 0; i < snapshot.DestroyedBricks.size(); i++) {
+        if (snapshot.DestroyedBricks[i] && !level.Bricks[i].Destroyed) {
+            level.DestroyBrick(i);
+            sceneLayer->InvalidateRegion(level.Bricks[i].Position, level.Bricks[i].Size);
+        }
+    }
+}
+
+// Renders a progress bar while assets are loading
+// The bar is drawn with scissored clears, as no shader may be available yet
+void Game::RenderLoadingScreen() {
+    float progress = loader->Progress();
+    int barWidth = FramebufferWidth / 2;
+    int barHeight = std::max(4u, FramebufferHeight / 40);
+    int barX = (FramebufferWidth - barWidth) / 2;
+    int barY = (FramebufferHeight - barHeight) / 2;
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(barX, barY, barWidth, barHeight);
+    glClearColor(0.3f, 0.3f, 0.3f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glScissor(barX, barY, (int)(barWidth * progress), barHeight);
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
 }
 
 // Checks and resolves collisions between game objects
 void Game::EnforceCollisions() {
-    for (GameObject &brick : Levels[CurLevel].Bricks) {
+    PROFILE_ZONE("Collisions");
+    GameLevel &level = Levels[CurLevel];
+    for (unsigned int i = 0; i < level.Bricks.size(); i++) {
+        GameObject &brick = level.Bricks[i];
         // ignore destroyed blocks
         if (brick.Destroyed) {
             continue;
@@ -233,14 +712,10 @@ void Game::EnforceCollisions() {
         
         if (!brick.IsSolid) {
             // non-solid blocks are destroyed when hit by the ball
-            brick.Destroyed = true;
-            SpawnPowerUps(brick);
-            sound->play2D("audio/bleep.mp3", false);
+            level.DestroyBrick(i);
+            Events.Emit(GAME_EVENT_BRICK_DESTROYED, brick.Position, i);
         } else {
-            // when the ball hits solid blocks, a short shake effect is introduced
-            ShakeTime = 0.05f;
-            effects->Shake = true;
-            sound->play2D("audio/solid.wav", false);
+            Events.Emit(GAME_EVENT_SOLID_HIT, brick.Position, i);
         }
         
         // the ball does not bounce back if the pass-through effect is enabled
@@ -276,31 +751,33 @@ void Game::EnforceCollisions() {
         ball->Velocity.y = -1.0f * abs(v0.y);
         ball->Velocity = glm::normalize(ball->Velocity) * glm::length(v0);
         ball->Stuck = ball->Sticky; // makes ball stuck on the paddle if the sticky paddle effect is enabled
-        sound->play2D("audio/bleep.wav", false);
+        Events.Emit(GAME_EVENT_PADDLE_HIT, ball->Position);
     }
     
-    // resolves collisions between powerups and the paddle
-    for (PowerUp &powerUp : PowerUps) {
-        if (!powerUp.Destroyed) {
-            if (powerUp.Position.y >= Height) {
-                powerUp.Destroyed = true;
-            }
-            if (CheckCollisions(*paddle, powerUp)) {
-                ActivatePowerUp(powerUp);
-                powerUp.Destroyed = true;
-                powerUp.Active = true;
-                sound->play2D("audio/powerup.wav", false);
-            }
+    // resolves collisions between falling powerups and the paddle. Powerups that fell off the screen are released.
+    // the list is walked from its end, as collected and released powerups are replaced by its last entry
+    const std::vector<unsigned int> &falling = PowerUps.Falling();
+    for (unsigned int i = (unsigned int)falling.size(); i-- > 0;) {
+        unsigned int slot = falling[i];
+        PowerUp &powerUp = PowerUps.Slot(slot);
+        if (CheckCollisions(*paddle, powerUp.Position, POWERUP_SIZE)) {
+            Events.Emit(GAME_EVENT_POWERUP_COLLECTED, powerUp.Position, powerUp.Type);
+            ActivatePowerUp(slot);
+        } else if (powerUp.Position.y >= Height) {
+            PowerUps.Release(slot);
         }
     }
 }
 
 // Clears all powerup effects and discards all remaining powerups
 void Game::ClearPowerUps() {
-    PowerUps.clear();
-    ActivePowerUps.clear();
-    effects->Chaos = false;
-    effects->Confuse = false;
+    for (unsigned int slot : PowerUps.Active()) {
+        Timers.Cancel(PowerUps.Slot(slot).Expiry);
+    }
+    PowerUps.Clear();
+    std::fill(ActivePowerUps, ActivePowerUps + NUM_POWERUP_TYPES, 0u);
+    Chaos = false;
+    Confuse = false;
 }
 
 // Resets the ball and the paddle to their original positions
@@ -312,93 +789,97 @@ void Game::ResetPlayer() {
     ball->Color = glm::vec3(1.0f);
 }
 
-// Reloads and resets the current level
+// Restores all blocks of the current level and the player's lives
 void Game::ResetLevel() {
     Lives = 3;
-    const char *path = ("levels/level"+std::to_string(CurLevel)+".txt").c_str();
-    Levels[CurLevel].Load(path, Width, Height / 2);
+    Levels[CurLevel].Reset();
+    LevelVersion++;
 }
 
 // Randomly spawn powerups at the position of a block
-void Game::SpawnPowerUps(GameObject &block) {
-    Texture2D tex_speed = ResourceManager::GetTexture("tex_speed");
-    Texture2D tex_sticky = ResourceManager::GetTexture("tex_sticky");
-    Texture2D tex_pass = ResourceManager::GetTexture("tex_pass");
-    Texture2D tex_size = ResourceManager::GetTexture("tex_size");
-    Texture2D tex_confuse = ResourceManager::GetTexture("tex_confuse");
-    Texture2D tex_chaos = ResourceManager::GetTexture("tex_chaos");
-    
+void Game::SpawnPowerUps(glm::vec2 position) {
     if (RollDice(20)) {
         // 5% probability of spawning a "speed increase" powerup
-        PowerUps.push_back(PowerUp("speed", glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, block.Position, tex_speed));
+        PowerUps.Spawn(POWERUP_SPEED, position);
     } else if (RollDice(19)) {
         // 5% probability of spawning a "sticky paddle" powerup
-        PowerUps.push_back(PowerUp("sticky", glm::vec3(1.0f, 0.5f, 1.0f), 5.0f, block.Position, tex_sticky));
+        PowerUps.Spawn(POWERUP_STICKY, position);
     } else if (RollDice(18)) {
         // 5% probability of spawning a "pass through" powerup
-        PowerUps.push_back(PowerUp("pass_through", glm::vec3(0.5f, 1.0f, 0.5f), 3.0f, block.Position, tex_pass));
+        PowerUps.Spawn(POWERUP_PASS_THROUGH, position);
     } else if (RollDice(17)) {
         // 5% probability of spawning a "pad size increase" powerup
-        PowerUps.push_back(PowerUp("pad_size_increase", glm::vec3(1.0f, 0.6f, 0.4f), 3.0f, block.Position, tex_size));
+        PowerUps.Spawn(POWERUP_PAD_SIZE_INCREASE, position);
     } else if (RollDice(8)) {
         // 10% probability of spawning a "confuse" powerup
-        PowerUps.push_back(PowerUp("confuse", glm::vec3(1.0f, 0.3f, 0.3f), 3.0f, block.Position, tex_confuse));
+        PowerUps.Spawn(POWERUP_CONFUSE, position);
     } else if (RollDice(7)) {
         // 10% probability of spawning a "chaos" powerup
-        PowerUps.push_back(PowerUp("chaos", glm::vec3(0.9f, 0.25f, 0.25f), 3.0f, block.Position, tex_chaos));
+        PowerUps.Spawn(POWERUP_CHAOS, position);
     }
 }
 
-// Updates the status of all existing powerups in the game
+// Moves the falling powerups. Collected powerups are ended by their timers.
 void Game::UpdatePowerUps(float dt) {
-    for (PowerUp &powerUp : PowerUps) {
-        // updates position of the powerup
-        powerUp.Position += powerUp.Velocity * dt;
-        if (!powerUp.Active) {
-            continue;
-        }
-        
-        powerUp.Duration -= dt;
-        if (powerUp.Duration <= 0.0f) {
-            // for powerups with a limited duration, removes its effect at the end of its lifetime
-            powerUp.Active = false;
-            if (powerUp.Type == "sticky" && --ActivePowerUps["sticky"] == 0) {
-                ball->Sticky = false;
-                paddle->Color = glm::vec3(1.0f);
-            } else if (powerUp.Type == "pass_through" && --ActivePowerUps["pass_through"] == 0) {
-                ball->PassThrough = false;
-                ball->Color = glm::vec3(1.0f);
-            } else if (powerUp.Type == "pad_size_increase" && --ActivePowerUps["pad_size_increase"] == 0) {
-                paddle->Size = PADDLE_SIZE;
-            } else if (powerUp.Type == "confuse" && --ActivePowerUps["confuse"] == 0) {
-                effects->Confuse = false;
-            } else if (powerUp.Type == "chaos" && --ActivePowerUps["chaos"] == 0) {
-                effects->Chaos = false;
-            }
-        }
+    PROFILE_ZONE("Powerups");
+    for (unsigned int slot : PowerUps.Falling()) {
+        PowerUps.Slot(slot).Position += POWERUP_V0 * dt;
     }
-    // remove inactive powerups from the list
-    PowerUps.erase(std::remove_if(PowerUps.begin(), PowerUps.end(), [](const PowerUp &powerUp) {return powerUp.Destroyed && !powerUp.Active;}), PowerUps.end());
+    METRIC_SET(METRIC_ACTIVE_POWERUPS, PowerUps.Active().size());
 }
 
-// Activates a powerup in the game
-void Game::ActivatePowerUp(PowerUp &powerUp) {
-    if (powerUp.Type == "speed") {
+// Activates a collected powerup in the game and schedules the end of its effect
+void Game::ActivatePowerUp(unsigned int slot) {
+    PowerUp &powerUp = PowerUps.Slot(slot);
+    if (powerUp.Type == POWERUP_SPEED) {
         ball->Velocity *= 1.2f;
-    } else if (powerUp.Type == "sticky") {
+    } else if (powerUp.Type == POWERUP_STICKY) {
         ball->Sticky = true;
         paddle->Color = glm::vec3(1.0f, 0.5f, 1.0f);
-    } else if (powerUp.Type == "pass_through") {
+    } else if (powerUp.Type == POWERUP_PASS_THROUGH) {
         ball->PassThrough = true;
         ball->Color = glm::vec3(1.0f, 0.5f, 0.5f);
-    } else if (powerUp.Type == "pad_size_increase" && paddle->Size.x == PADDLE_SIZE.x) {
+    } else if (powerUp.Type == POWERUP_PAD_SIZE_INCREASE && paddle->Size.x == PADDLE_SIZE.x) {
         paddle->Size.x += 50;
-    } else if (powerUp.Type == "confuse") {
-        effects->Confuse = true;
-    } else if (powerUp.Type == "chaos") {
-        effects->Chaos = true;
+    } else if (powerUp.Type == POWERUP_CONFUSE) {
+        Confuse = true;
+    } else if (powerUp.Type == POWERUP_CHAOS) {
+        Chaos = true;
     }
     ActivePowerUps[powerUp.Type]++;
+    PowerUps.Activate(slot);
+    powerUp.Expiry = Timers.Schedule(StepsUntil(POWERUP_DURATIONS[powerUp.Type]), {TIMER_POWERUP_EXPIRY, slot});
+}
+
+// Handles a timer of the game's timer wheel that ran out
+void Game::ExpireTimer(TimerEvent event) {
+    if (event.Kind == TIMER_POWERUP_EXPIRY) {
+        ExpirePowerUp(event.Data);
+    } else if (event.Kind == TIMER_SHAKE_END) {
+        Shake = false;
+    }
+}
+
+// Releases a powerup whose effect ran out, and removes the effect unless another powerup of its type is still active
+void Game::ExpirePowerUp(unsigned int slot) {
+    PowerUpType type = PowerUps.Slot(slot).Type;
+    PowerUps.Release(slot);
+    if (--ActivePowerUps[type] > 0) {
+        return;
+    }
+    if (type == POWERUP_STICKY) {
+        ball->Sticky = false;
+        paddle->Color = glm::vec3(1.0f);
+    } else if (type == POWERUP_PASS_THROUGH) {
+        ball->PassThrough = false;
+        ball->Color = glm::vec3(1.0f);
+    } else if (type == POWERUP_PAD_SIZE_INCREASE) {
+        paddle->Size = PADDLE_SIZE;
+    } else if (type == POWERUP_CONFUSE) {
+        Confuse = false;
+    } else if (type == POWERUP_CHAOS) {
+        Chaos = false;
+    }
 }
 
 // Given a vector in 2D space, returns the most closely-aligned direction out of the four primary orthogonal direction vectors
@@ -423,8 +904,15 @@ Direction ClosestDir(glm::vec2 target) {
 
 // Checks collision between two AABBs
 bool CheckCollisions(GameObject &a, GameObject &b) {
-    bool colX = (a.Position.x + a.Size.x >= b.Position.x) && (b.Position.x + b.Size.x >= a.Position.x);
-    bool colY = (a.Position.y + a.Size.y >= b.Position.y) && (b.Position.y + b.Size.y >= a.Position.y);
+    return CheckCollisions(a, b.Position, b.Size);
+}
+
+// Checks collision between an object and a box given by its position and size, such as a powerup
+bool CheckCollisions(const GameObject &a, glm::vec2 position, glm::vec2 size) {
+    bool colX = (a.Position.x + a.Size.x >= position.x) && (position.x + size.x >= a.Position.x);
+    bool colY = (a.Position.y + a.Size.y >= position.y) && (position.y + size.y >= a.Position.y);
+    METRIC_ADD(METRIC_COLLISION_TESTS, 1);
+    METRIC_ADD(METRIC_COLLISION_HITS, colX && colY);
     return colX && colY;
 }
 
@@ -437,7 +925,9 @@ CollisionRes CheckCollisions(Ball &ball, GameObject &block) {
     D = glm::clamp(D, -block.Size / 2.0f, block.Size / 2.0f);
     glm::vec2 P = B + D;
     glm::vec2 diff = P - C;
+    METRIC_ADD(METRIC_COLLISION_TESTS, 1);
     if (glm::length(diff) <= ball.Radius) {
+        METRIC_ADD(METRIC_COLLISION_HITS, 1);
         return std::make_tuple(true, ClosestDir(diff), diff);
     } else {
         return std::make_tuple(false, UP, glm::vec2(0.0f)); // the last two parameters are meaningless if there is no collision
@@ -445,7 +935,15 @@ CollisionRes CheckCollisions(Ball &ball, GameObject &block) {
 }
 
 // Randomly returns a boolean result where the probability of returning true is 1/range
-bool RollDice(unsigned int range) {
-    unsigned int random = rand() % range;
+// Uses the simulation's own engine, as rand() is shared with particles spawned on the render thread
+bool Game::RollDice(unsigned int range) {
+    unsigned int random = Random() % range;
     return random == 0;
 }
+
+// Returns the delay on the timer wheel of an effect lasting a number of seconds from the current step
+// The current step counts towards the duration, as timers expire at the end of the step they are due in
+unsigned long long StepsUntil(float seconds) {
+    long long steps = std::lround(seconds * SIMULATION_RATE);
+    return steps > 1 ? steps - 1 : 0;
+}
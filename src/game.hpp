@@ -1,7 +1,7 @@
 /*
  game.hpp
  Breakout
- Last updated on October 5, 2020
+ Last updated on October 19, 2026
  
  Declaration of the Game class
  A singleton class that outlines and controls the life cycle of the game
@@ -13,19 +13,33 @@
 #include <glad/glad.h>
 #include <GLFW/GLFW3.H>
 
+#include <atomic>
+#include <random>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 
 #include "game_level.hpp"
 #include "power_up.hpp"
+#include "ball.hpp"
+#include "spsc_queue.hpp"
+#include "frame_pacer.hpp"
+#include "benchmark.hpp"
+#include "timer_wheel.hpp"
+#include "game_events.hpp"
+#include "audio.hpp"
 
 const unsigned int NUM_LEVELS = 4; // number of levels
 const glm::vec2 PADDLE_SIZE(100.0f, 20.0f); // size of player-controlled paddle
 const float PADDLE_VELOCITY(500.0f); // horizontal velocity of the paddle
 const float BALL_RADIUS = 12.5f; // default radius of the ball
 const glm::vec2 BALL_V0(100.0f, -350.0f); // initial velocity of the ball
+const double SIMULATION_RATE = 120.0; // simulation steps per second, independent of the frame rate
+const float SHAKE_DURATION = 0.05f; // seconds the screen shakes after the ball hits a solid block
+const unsigned int LATCH_TRANSITIONS = 8; // presses and releases of a paddle key remembered for the late latch, more than a frame ever has
 
 enum GameState {
+    GAME_LOADING, // assets are being loaded
     GAME_ACTIVE, // currently playing
     GAME_MENU, // level selection
     GAME_WIN // game won
@@ -37,36 +51,145 @@ enum Direction {
 
 typedef std::tuple<bool, Direction, glm::vec2> CollisionRes;
 
+// Kinds of timers on the game's timer wheel
+enum GameTimer {
+    TIMER_POWERUP_EXPIRY, // data is the powerup's slot in the pool
+    TIMER_SHAKE_END
+};
+
+// Settings of the offscreen scene, configurable from the command line
+struct RenderSettings {
+    float RenderScale = 1.0f; // resolution of the scene relative to the window's framebuffer
+    unsigned int Samples = 4; // number of MSAA samples, 0 disables multi-sampling
+    float TargetFrameRate = 0.0f; // frame rate held by the dynamic resolution controller, 0 disables it
+    float MinRenderScale = 0.5f; // lower bound of the render scale under dynamic resolution
+    PresentMode Present = PRESENT_VSYNC;
+    float FrameRateLimit = 60.0f; // frame rate under PRESENT_LIMITED
+    bool LateLatch = false; // samples input again right before the paddle is drawn
+    bool FrameStats = false; // prints frame-time and input latency statistics
+};
+
+// A key press or release, passed from the window thread to the simulation thread
+struct KeyEvent {
+    int Key;
+    int Action;
+    double Time; // when the event was received, in seconds of glfwGetTime
+};
+
+// Copy of everything the render thread draws, published by the simulation after each step
+// The render thread never reads the simulation's own objects, so it never waits for a step to finish
+struct RenderSnapshot {
+    GameState State;
+    double Time; // end of the simulated step, in seconds of glfwGetTime
+    double InputTime; // when the latest key event applied by the simulation was received
+    unsigned int CurLevel;
+    unsigned int LevelVersion; // changes whenever the destroyed blocks of the current level are restored
+    unsigned int Lives;
+    std::vector<unsigned char> DestroyedBricks; // one flag per block of the current level
+    GameObject PaddleState;
+    Ball BallState;
+    std::vector<PowerUp> PowerUps; // falling powerups
+    bool Chaos, Confuse, Shake; // post-processing effects
+    
+    RenderSnapshot(const GameObject &paddle, const Ball &ball) : State(GAME_MENU), Time(0.0), InputTime(0.0), CurLevel(0), LevelVersion(0), Lives(0), PaddleState(paddle), BallState(ball), Chaos(false), Confuse(false), Shake(false) {}
+};
+
+// A press or release of a paddle key
+struct KeyTransition {
+    double Time;
+    bool Held;
+};
+
+// The latest presses and releases of a paddle key, tracked on the window thread for the late latch
+// Every transition is kept, so that a tap shorter than a simulation step still moves the latched paddle
+struct LatchKey {
+    KeyTransition Transitions[LATCH_TRANSITIONS] = {}; // ring of the latest transitions, oldest first from Count
+    unsigned int Count = 0; // transitions recorded since the game started
+    
+    void Record(bool held, double time);
+    bool HeldAt(double time) const;
+};
+
 class Game {
 public:
     GameState State; // current 
-    bool Keys[1024]; // press/release state of each key
-    unsigned int Width, Height; // window dimensions
+    bool Keys[1024]; // press/release state of each key, only used by the simulation
+    unsigned int Width, Height; // window dimensions in game coordinates
+    unsigned int FramebufferWidth, FramebufferHeight; // window dimensions in pixels
+    RenderSettings Settings;
+    BenchmarkSettings BenchmarkMode; // when enabled, the simulation is stepped by the benchmark instead of its own thread
+    AudioSettings AudioMode;
     std::vector<GameLevel> Levels; // collection of all levels
     unsigned int CurLevel; // currently selected level
-    std::vector<PowerUp> PowerUps; // collection of all active powerups
+    PowerUpPool PowerUps; // falling powerups and collected powerups whose effects are active
     bool KeysProcessed[1024]; // indication of whether actions have already been triggered in the current continuous session
     unsigned int Lives; // player lives remaining
+    double FrameInputTime; // when the latest input shown by the last rendered frame was received
+    unsigned int BricksDestroyed; // blocks destroyed since the game started
     
     Game(unsigned int width, unsigned int height);
     ~Game();
     
     void Init();
-    void ProcessInput(float dt);
+    void Resize(unsigned int framebufferWidth, unsigned int framebufferHeight);
+    void QueueKeyEvent(int key, int action);
+    void ProcessInput(double stepStart, float dt);
     void Update(float dt);
-    void Render();
+    bool FrameDue(double &timeout);
+    void Render(float dt);
+    void RequestRedraw();
+    void StopSimulation();
+    void StepBenchmark(unsigned int tick);
     void EnforceCollisions();
     void ResetPlayer();
     void ResetLevel();
-    void SpawnPowerUps(GameObject &block);
+    void SpawnPowerUps(glm::vec2 position);
     void UpdatePowerUps(float dt);
     
 private:
-    float ShakeTime;
-    std::unordered_map<std::string, unsigned int> ActivePowerUps;
+    TimerWheel Timers; // ends timed effects, on simulation steps
+    TimerHandle ShakeTimer;
+    GameEventBuffer Events; // gameplay events of the current step
+    unsigned int ActivePowerUps[NUM_POWERUP_TYPES]; // number of active powerups of each type
+    float BallStuckTime; // part of the current step the ball spent stuck on the paddle
+    bool Chaos, Confuse, Shake; // post-processing effects requested by the simulation
+    unsigned int LevelVersion; // incremented whenever the destroyed blocks of the current level are restored
+    std::minstd_rand Random; // only drawn from by the simulation, so its rolls don't depend on rendering
+    SPSCQueue<KeyEvent, 256> KeyEvents; // filled by the window thread, drained before each simulation step
+    std::thread SimulationThread;
+    std::atomic<bool> SimulationRunning;
+    bool ResizePending; // the render targets are resized at the start of the next frame
+    double SimulationTime; // end of the last simulated step
+    double LastInputTime; // when the latest key event applied by the simulation was received
+    double WindowInputTime; // when the latest key event was received on the window thread
+    LatchKey LatchKeys[2]; // A and D
+    GameState RenderedState; // state shown by the last rendered frame
+    double LastFrameTime; // when the last frame was rendered
+    bool RedrawRequested; // the window needs a frame even though the game is idle
     
-    void ActivatePowerUp(PowerUp &powerUp);
+    void FinishInit();
+    void StartSimulation();
+    void RunSimulation();
+    void ProcessKeyActions(float offset);
+    void DriveAutopilot(double time);
+    void SetAutopilotKey(int key, bool held, double time);
+    void MovePaddle(float dt);
+    void PublishSnapshot();
+    void SyncLevel(const RenderSnapshot &snapshot);
+    void LatchPaddle(const RenderSnapshot &snapshot, GameObject &paddleState, Ball &ballState);
+    void RenderLoadingScreen();
+    void ActivatePowerUp(unsigned int slot);
+    void ExpireTimer(TimerEvent event);
+    void HandleEvents();
+    void ExpirePowerUp(unsigned int slot);
     void ClearPowerUps();
+    bool RollDice(unsigned int range);
 };
 
+// Collision tests, exposed for the microbenchmarks
+Direction ClosestDir(glm::vec2 target);
+bool CheckCollisions(GameObject &a, GameObject &b);
+bool CheckCollisions(const GameObject &a, glm::vec2 position, glm::vec2 size);
+CollisionRes CheckCollisions(Ball &ball, GameObject &block);
+
 #endif /* game_hpp */
@@ -0,0 +1,55 @@
+/*
+ game_events.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration and implementation of the GameEventBuffer class
+ A fixed-capacity buffer of the gameplay events emitted during a simulation step, consumed in a batch once the step's physics are done.
+ */
+
+#ifndef game_events_hpp
+#define game_events_hpp
+
+#include <glm/glm.hpp>
+
+const unsigned int GAME_EVENT_CAPACITY = 1024; // events per step, further events are dropped
+
+enum GameEventType {
+    GAME_EVENT_BRICK_DESTROYED, // data is the index of the brick
+    GAME_EVENT_SOLID_HIT, // data is the index of the brick
+    GAME_EVENT_PADDLE_HIT,
+    GAME_EVENT_POWERUP_COLLECTED, // data is the powerup's type
+    GAME_EVENT_LIFE_LOST, // data is the number of lives left
+    NUM_GAME_EVENT_TYPES
+};
+
+struct GameEvent {
+    GameEventType Type;
+    unsigned int Data;
+    glm::vec2 Position; // where the event happened
+};
+
+// Filled by the simulation while it resolves a step and emptied once the step's events have been handled
+// Consumers see all events of a step at once, so they can merge simultaneous events, e.g. play one sound for three hits
+class GameEventBuffer {
+public:
+    unsigned long long Dropped = 0; // events lost because the buffer was full
+    
+    void Emit(GameEventType type, glm::vec2 position, unsigned int data = 0) {
+        if (Count == GAME_EVENT_CAPACITY) {
+            Dropped++;
+            return;
+        }
+        Events[Count++] = {type, data, position};
+    }
+    void Clear() { Count = 0; }
+    unsigned int Size() const { return Count; }
+    const GameEvent *begin() const { return Events; }
+    const GameEvent *end() const { return Events + Count; }
+    
+private:
+    GameEvent Events[GAME_EVENT_CAPACITY];
+    unsigned int Count = 0;
+};
+
+#endif /* game_events_hpp */
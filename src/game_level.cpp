@@ -1,37 +1,70 @@
 /*
  game_level.cpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Implementation of the GameLevel class
  Defines a level in the game consisting of layers of blocks
  */
 
 #include <sstream>
-#include <fstream>
 #include <iostream>
 
 #include "game_level.hpp"
+#include "asset_archive.hpp"
+#include "gl_state.hpp"
+#include "metrics.hpp"
 
-// colors of the blocks
-const glm::vec3 COLOR_SOLID(0.8f, 0.8f, 0.7f);
-const glm::vec3 COLOR_BREAKABLE1(0.2f, 0.6f, 1.0f);
-const glm::vec3 COLOR_BREAKABLE2(0.0f, 0.7f, 0.0f);
-const glm::vec3 COLOR_BREAKABLE3(0.8f, 0.8f, 0.4f);
-const glm::vec3 COLOR_BREAKABLE4(1.0f, 0.5f, 0.0f);
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
 
-GameLevel::GameLevel() {}
+GameLevel::GameLevel() : VAO(0), QuadVBO(0), InstanceVBO(0), RemainingBreakable(0), DirtyBegin(0), DirtyEnd(0), InstancesAllocated(false) {}
 
-// Constructs a GameLevel from a text file
-void GameLevel::Load(const char *file, unsigned int levelWidth, unsigned int levelHeight) {
+// Copies the blocks of a level, but not its OpenGL objects
+GameLevel::GameLevel(const GameLevel &other) : Bricks(other.Bricks), VAO(0), QuadVBO(0), InstanceVBO(0), RemainingBreakable(other.RemainingBreakable), Instances(other.Instances), DirtyBegin(0), DirtyEnd(0), InstancesAllocated(false), SolidTexture(other.SolidTexture), BreakableTexture(other.BreakableTexture) {}
+
+// Takes over the blocks and the OpenGL objects of a level
+GameLevel::GameLevel(GameLevel &&other) : Bricks(std::move(other.Bricks)), VAO(other.VAO), QuadVBO(other.QuadVBO), InstanceVBO(other.InstanceVBO), RemainingBreakable(other.RemainingBreakable), Instances(std::move(other.Instances)), DirtyBegin(other.DirtyBegin), DirtyEnd(other.DirtyEnd), InstancesAllocated(other.InstancesAllocated), SolidTexture(other.SolidTexture), BreakableTexture(other.BreakableTexture) {
+    other.VAO = other.QuadVBO = other.InstanceVBO = 0;
+    other.InstancesAllocated = false;
+}
+
+GameLevel::~GameLevel() {
+    ReleaseRenderData();
+}
+
+// Copy or move assignment, depending on how the argument was constructed
+GameLevel &GameLevel::operator=(GameLevel other) {
+    ReleaseRenderData();
+    Bricks = std::move(other.Bricks);
+    Instances = std::move(other.Instances);
+    RemainingBreakable = other.RemainingBreakable;
+    DirtyBegin = other.DirtyBegin;
+    DirtyEnd = other.DirtyEnd;
+    InstancesAllocated = other.InstancesAllocated;
+    SolidTexture = other.SolidTexture;
+    BreakableTexture = other.BreakableTexture;
+    VAO = other.VAO;
+    QuadVBO = other.QuadVBO;
+    InstanceVBO = other.InstanceVBO;
+    other.VAO = other.QuadVBO = other.InstanceVBO = 0;
+    return *this;
+}
+
+// Constructs a GameLevel from a text file in the asset archive
+void GameLevel::Load(const std::string &file, unsigned int levelWidth, unsigned int levelHeight) {
     Bricks.clear();
+    Instances.clear();
+    RemainingBreakable = 0;
     
     unsigned int tileCode;
     GameLevel level;
     std::string line;
-    std::ifstream f(file);
+    AssetBlob blob;
     std::vector<std::vector<unsigned int>> tileData; // stores block data in a 2D vector
-    if (f) {
+    if (AssetArchive::Load(file, blob)) {
+        std::istringstream f(blob.String());
         while (std::getline(f, line)) {
             std::istringstream s(line);
             std::vector<unsigned int> row;
@@ -42,34 +75,91 @@ void GameLevel::Load(const char *file, unsigned int levelWidth, unsigned int lev
         }if (tileData.size() > 0) {
             Init(tileData, levelWidth, levelHeight);
         }
+    } else {
+        std::cout << "ERROR::LEVEL: Failed to read level file " << file << std::endl;
     }
 }
 
-// Renders all undestroyed blocks in the level
-void GameLevel::Draw(SpriteRenderer &renderer) {
-    for (GameObject &brick : Bricks) {
-        if (!brick.Destroyed) {
-            brick.Draw(renderer);
+// Fills the level with random blocks drawn from rand, so that a seeded level is always the same
+// Every tile holds a block, one in twenty of them solid. Used to stress the game in benchmarks.
+void GameLevel::Generate(unsigned int columns, unsigned int rows, unsigned int levelWidth, unsigned int levelHeight) {
+    Bricks.clear();
+    Instances.clear();
+    RemainingBreakable = 0;
+    
+    std::vector<std::vector<unsigned int>> tileData(rows, std::vector<unsigned int>(columns));
+    for (std::vector<unsigned int> &row : tileData) {
+        for (unsigned int &tileCode : row) {
+            tileCode = rand() % 20 == 0 ? 1 : 2 + rand() % 4;
         }
     }
+    Init(tileData, levelWidth, levelHeight);
 }
 
-// Level is cleared if all non-solid blocks are destroyed
-bool GameLevel::Cleared() {
-    for (GameObject &brick : Bricks) {
-        if (!brick.IsSolid && !brick.Destroyed) {
-            return false;
+// Restores all destroyed blocks without reloading the level file
+void GameLevel::Reset() {
+    RemainingBreakable = 0;
+    for (unsigned int i = 0; i < Bricks.size(); i++) {
+        Bricks[i].Destroyed = false;
+        Instances[i].Flags = BRICK_ALIVE | (Bricks[i].IsSolid ? BRICK_SOLID : 0);
+        if (!Bricks[i].IsSolid) {
+            RemainingBreakable++;
         }
     }
-    return true;
+    DirtyBegin = 0;
+    DirtyEnd = (unsigned int)Bricks.size();
+}
+
+// Renders all undestroyed blocks in the level with a single instanced draw call
+// Destroyed blocks are discarded by the vertex shader
+void GameLevel::Draw(Shader &shader) {
+    if (Bricks.empty()) {
+        return;
+    }
+    UploadInstances();
+    shader.Use();
+    GLState::ActiveTexture(GL_TEXTURE1);
+    BreakableTexture.Bind();
+    GLState::ActiveTexture(GL_TEXTURE0);
+    SolidTexture.Bind();
+    GLState::BindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)Bricks.size());
+    METRIC_ADD(METRIC_DRAW_CALLS, 1);
 }
 
-// Creates GameObjects based on a 2D vector of block data loaded from file
+// Destroys a block and clears its alive flag. Does not use OpenGL; the instance buffer is updated on the next Draw.
+void GameLevel::DestroyBrick(unsigned int index) {
+    GameObject &brick = Bricks[index];
+    if (brick.Destroyed) {
+        return;
+    }
+    brick.Destroyed = true;
+    if (!brick.IsSolid) {
+        RemainingBreakable--;
+    }
+    Instances[index].Flags = brick.IsSolid ? BRICK_SOLID : 0;
+    if (DirtyBegin == DirtyEnd) {
+        DirtyBegin = index;
+        DirtyEnd = index + 1;
+    } else {
+        DirtyBegin = std::min(DirtyBegin, index);
+        DirtyEnd = std::max(DirtyEnd, index + 1);
+    }
+}
+
+// Level is cleared if all non-solid blocks are destroyed
+bool GameLevel::Cleared() {
+    return RemainingBreakable == 0;
+}
+
+// Creates GameObjects and their instances based on a 2D vector of block data loaded from file
 void GameLevel::Init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight) {
     unsigned int nrCols = (unsigned int)tileData[0].size();
     unsigned int nrRows = (unsigned int)tileData.size();
     float unit_width = levelWidth / nrCols;
     float unit_height = levelHeight / nrRows;
+    SolidTexture = ResourceManager::GetTexture("block_solid");
+    BreakableTexture = ResourceManager::GetTexture("block_breakable");
     
     for (unsigned int i = 0; i < nrRows; i++) {
         for (unsigned int j = 0; j < nrCols; j++) {
@@ -82,32 +172,83 @@ void GameLevel::Init(std::vector<std::vector<unsigned int>> tileData, unsigned i
             glm::vec2 size(unit_width, unit_height);
             Texture2D sprite;
             bool isSolid;
-            glm::vec3 color;
+            unsigned int colorIndex;
             if (tileData[i][j] == 1) { // a 1 signifies a solid block
                 isSolid = true;
-                sprite = ResourceManager::GetTexture("block_solid");
-                color = COLOR_SOLID;
+                sprite = SolidTexture;
+                colorIndex = 0;
             } else {
                 isSolid = false;
-                sprite = ResourceManager::GetTexture("block_breakable");
+                sprite = BreakableTexture;
                 // numbers 2 to 5 all indicate non-solid blocks which differ in color
-                switch (tileData[i][j]) {
-                    case 2:
-                        color = COLOR_BREAKABLE1;
-                        break;
-                    case 3:
-                        color = COLOR_BREAKABLE2;
-                        break;
-                    case 4:
-                        color = COLOR_BREAKABLE3;
-                        break;
-                    case 5:
-                        color = COLOR_BREAKABLE4;
-                        break;
-                }
+                colorIndex = std::min(tileData[i][j] - 1, NUM_BLOCK_COLORS - 1);
+                RemainingBreakable++;
             }
+            glm::vec3 color = BLOCK_COLORS[colorIndex];
             GameObject block(pos, size, sprite, color, isSolid);
             Bricks.push_back(block);
+            Instances.push_back({pos, size, colorIndex, BRICK_ALIVE | (isSolid ? BRICK_SOLID : 0)});
         }
     }
+    InstancesAllocated = false;
+}
+
+// Uploads the instances changed since the last upload, creating the instance buffer on first use
+// Only called by Draw, so a level that is never drawn never uses OpenGL
+void GameLevel::UploadInstances() {
+    if (!VAO) {
+        InitRenderData();
+    }
+    GLState::BindBuffer(GL_ARRAY_BUFFER, InstanceVBO);
+    if (!InstancesAllocated) {
+        glBufferData(GL_ARRAY_BUFFER, Instances.size() * sizeof(BrickInstance), Instances.data(), GL_STATIC_DRAW);
+        METRIC_ADD(METRIC_UPLOADED_BYTES, Instances.size() * sizeof(BrickInstance));
+        InstancesAllocated = true;
+    } else if (DirtyBegin < DirtyEnd) {
+        glBufferSubData(GL_ARRAY_BUFFER, DirtyBegin * sizeof(BrickInstance), (DirtyEnd - DirtyBegin) * sizeof(BrickInstance), &Instances[DirtyBegin]);
+        METRIC_ADD(METRIC_UPLOADED_BYTES, (DirtyEnd - DirtyBegin) * sizeof(BrickInstance));
+    }
+    DirtyBegin = DirtyEnd = 0;
+}
+
+// Prepares the VAO, the quad VBO and the instance VBO. Only has to be called once per level.
+void GameLevel::InitRenderData() {
+    float quadVertices[] = {
+        0.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 1.0f,
+        1.0f, 0.0f, 1.0f, 0.0f,
+        1.0f, 1.0f, 1.0f, 1.0f
+    };
+    
+    glGenVertexArrays(1, &VAO);
+    GLState::BindVertexArray(VAO);
+    glGenBuffers(1, &QuadVBO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, QuadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    // position and size of a block are packed in one vec4, color index and flags in one uvec2
+    glGenBuffers(1, &InstanceVBO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, InstanceVBO);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(BrickInstance), (void*)offsetof(BrickInstance, Position));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 2, GL_UNSIGNED_INT, sizeof(BrickInstance), (void*)offsetof(BrickInstance, ColorIndex));
+    glVertexAttribDivisor(3, 1);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
+}
+
+// Deletes the VAO and buffers, if the level was ever drawn. A level that was not makes no OpenGL calls.
+void GameLevel::ReleaseRenderData() {
+    if (!VAO) {
+        return;
+    }
+    GLState::DeleteVertexArray(VAO);
+    GLState::DeleteBuffer(QuadVBO);
+    GLState::DeleteBuffer(InstanceVBO);
+    VAO = QuadVBO = InstanceVBO = 0;
 }
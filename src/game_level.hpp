@@ -1,7 +1,7 @@
 /*
  game_level.hpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Declaration of the GameLevel class
  Defines a level in the game consisting of layers of blocks
@@ -13,24 +13,69 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <string>
 #include <vector>
 
 #include "game_object.hpp"
 #include "sprite_renderer.hpp"
 #include "resource_manager.hpp"
 
+// colors of the blocks, indexed by the color index stored in each brick instance
+const unsigned int NUM_BLOCK_COLORS = 5;
+const glm::vec3 BLOCK_COLORS[NUM_BLOCK_COLORS] = {
+    glm::vec3(0.8f, 0.8f, 0.7f), // solid
+    glm::vec3(0.2f, 0.6f, 1.0f), // breakable 1
+    glm::vec3(0.0f, 0.7f, 0.0f), // breakable 2
+    glm::vec3(0.8f, 0.8f, 0.4f), // breakable 3
+    glm::vec3(1.0f, 0.5f, 0.0f) // breakable 4
+};
+
+// flags stored in each brick instance
+const unsigned int BRICK_ALIVE = 1;
+const unsigned int BRICK_SOLID = 2;
+
+// Per-instance data of a block as stored in the GPU instance buffer
+struct BrickInstance {
+    glm::vec2 Position;
+    glm::vec2 Size;
+    unsigned int ColorIndex;
+    unsigned int Flags;
+};
+
+// Owns the VAO and buffers it draws with. A copy shares none of them and creates its own when first drawn.
 class GameLevel {
 public:
     std::vector<GameObject> Bricks; // stores data of all blocks in the level in order
     
     GameLevel();
+    GameLevel(const GameLevel &other);
+    GameLevel(GameLevel &&other);
+    ~GameLevel();
+    GameLevel &operator=(GameLevel other);
     
-    void Load(const char *file, unsigned int levelWidth, unsigned int levelHeight); // loads a level from an external text file
-    void Draw(SpriteRenderer &renderer);
+    void Load(const std::string &file, unsigned int levelWidth, unsigned int levelHeight); // loads a level from a text file in the asset archive
+    void Generate(unsigned int columns, unsigned int rows, unsigned int levelWidth, unsigned int levelHeight); // fills a level with random blocks
+    void Reset(); // restores all destroyed blocks
+    void Draw(Shader &shader);
+    void DestroyBrick(unsigned int index);
     bool Cleared();
     
 private:
-    void Init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight); // called inside Load
+    friend struct MicrobenchAccess; // tools/microbench times Init without reading a file
+    
+    unsigned int VAO;
+    unsigned int QuadVBO;
+    unsigned int InstanceVBO; // one BrickInstance per block, created on the first Draw
+    unsigned int RemainingBreakable; // number of breakable blocks that are not yet destroyed
+    std::vector<BrickInstance> Instances; // CPU copy of the instance buffer
+    unsigned int DirtyBegin, DirtyEnd; // range of instances changed since the last upload
+    bool InstancesAllocated; // whether the instance buffer has the size of Instances
+    Texture2D SolidTexture, BreakableTexture; // looked up once in Init, so that Draw does not search the resource manager
+    
+    void Init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight); // called inside Load and Generate
+    void InitRenderData();
+    void UploadInstances();
+    void ReleaseRenderData();
 };
 
 #endif /* game_level_hpp */
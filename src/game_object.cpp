@@ -1,7 +1,7 @@
 /*
  game_object.cpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Implementation of the GameObject class
  Base class for all objects used in the game, including blocks, the paddle and the ball.
@@ -17,7 +17,7 @@ GameObject::GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec
 
 GameObject::~GameObject() {}
 
-// Renders the GameObject with a SpriteRenderer
-void GameObject::Draw(SpriteRenderer &renderer) {
-    renderer.DrawSprite(Sprite, Position, Size, Rotation, Color);
+// Records the GameObject's sprite in a render queue
+void GameObject::Draw(SpriteRenderer &renderer, RenderQueue &queue, RenderLayer layer) const {
+    renderer.QueueSprite(queue, layer, Sprite, Position, Size, Rotation, Color);
 }
@@ -1,7 +1,7 @@
 /*
  game_object.hpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Declaration of the GameObject class
  Base class for all objects used in the game, including blocks, the paddle and the ball.
@@ -31,7 +31,7 @@ public:
     GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec3 color = glm::vec3(1.0f), bool isSolid = false);
     virtual ~GameObject();
     
-    virtual void Draw(SpriteRenderer &renderer);
+    virtual void Draw(SpriteRenderer &renderer, RenderQueue &queue, RenderLayer layer) const;
     
 protected:
     static glm::vec2 Acceleration; // acceleration is constant throughout the game
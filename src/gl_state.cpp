@@ -0,0 +1,141 @@
+/*
+ gl_state.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the GLState class
+ A singleton that tracks the bound OpenGL objects and skips state changes that would not change anything.
+ */
+
+#include "gl_state.hpp"
+#include "metrics.hpp"
+
+const unsigned int GL_STATE_UNKNOWN = 0xFFFFFFFF; // stands in for a binding the cache does not know
+
+// Instantiate static variables. Nothing is known about the context until state is set through the cache.
+GLStateStats GLState::Stats;
+unsigned int GLState::Program = GL_STATE_UNKNOWN;
+unsigned int GLState::Unit = GL_STATE_UNKNOWN;
+unsigned int GLState::Textures[GL_STATE_TEXTURE_UNITS] = {GL_STATE_UNKNOWN, GL_STATE_UNKNOWN, GL_STATE_UNKNOWN, GL_STATE_UNKNOWN};
+unsigned int GLState::VAO = GL_STATE_UNKNOWN;
+unsigned int GLState::ArrayBuffer = GL_STATE_UNKNOWN;
+int GLState::Blend = -1;
+GLenum GLState::BlendSource = GL_STATE_UNKNOWN;
+GLenum GLState::BlendDestination = GL_STATE_UNKNOWN;
+
+// Makes a program current unless it already is
+void GLState::UseProgram(unsigned int program) {
+    if (Changed(Program != program)) {
+        glUseProgram(program);
+        Program = program;
+    }
+}
+
+// Selects the texture unit affected by BindTexture, e.g. GL_TEXTURE0
+void GLState::ActiveTexture(GLenum unit) {
+    if (Changed(Unit != unit - GL_TEXTURE0)) {
+        glActiveTexture(unit);
+        Unit = unit - GL_TEXTURE0;
+    }
+}
+
+// Binds a texture to GL_TEXTURE_2D of the active texture unit
+void GLState::BindTexture(unsigned int texture) {
+    bool tracked = Unit < GL_STATE_TEXTURE_UNITS;
+    if (Changed(!tracked || Textures[Unit] != texture)) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        if (tracked) {
+            Textures[Unit] = texture;
+        }
+    }
+}
+
+void GLState::BindVertexArray(unsigned int vao) {
+    if (Changed(VAO != vao)) {
+        glBindVertexArray(vao);
+        VAO = vao;
+    }
+}
+
+// Binds a buffer. Only GL_ARRAY_BUFFER is tracked; other targets, such as the element buffer stored in vertex arrays, are always bound.
+void GLState::BindBuffer(GLenum target, unsigned int buffer) {
+    bool tracked = target == GL_ARRAY_BUFFER;
+    if (Changed(!tracked || ArrayBuffer != buffer)) {
+        glBindBuffer(target, buffer);
+        if (tracked) {
+            ArrayBuffer = buffer;
+        }
+    }
+}
+
+void GLState::SetBlend(bool enabled) {
+    if (Changed(Blend != (int)enabled)) {
+        if (enabled) {
+            glEnable(GL_BLEND);
+        } else {
+            glDisable(GL_BLEND);
+        }
+        Blend = enabled;
+    }
+}
+
+void GLState::BlendFunc(GLenum source, GLenum destination) {
+    if (Changed(BlendSource != source || BlendDestination != destination)) {
+        glBlendFunc(source, destination);
+        BlendSource = source;
+        BlendDestination = destination;
+    }
+}
+
+// Deletes a program. A deleted program stays in use until another one is made current, so the binding becomes unknown.
+void GLState::DeleteProgram(unsigned int program) {
+    glDeleteProgram(program);
+    if (Program == program) {
+        Program = GL_STATE_UNKNOWN;
+    }
+}
+
+// Deletes a texture. OpenGL unbinds a deleted texture from all units, and so does the cache.
+void GLState::DeleteTexture(unsigned int texture) {
+    glDeleteTextures(1, &texture);
+    for (unsigned int i = 0; i < GL_STATE_TEXTURE_UNITS; i++) {
+        if (Textures[i] == texture) {
+            Textures[i] = 0;
+        }
+    }
+}
+
+void GLState::DeleteVertexArray(unsigned int vao) {
+    glDeleteVertexArrays(1, &vao);
+    if (VAO == vao) {
+        VAO = 0;
+    }
+}
+
+void GLState::DeleteBuffer(unsigned int buffer) {
+    glDeleteBuffers(1, &buffer);
+    if (ArrayBuffer == buffer) {
+        ArrayBuffer = 0;
+    }
+}
+
+// Forgets all tracked state, e.g. after code outside the cache changed bindings. The next change of each kind is always issued.
+void GLState::Invalidate() {
+    Program = Unit = VAO = ArrayBuffer = GL_STATE_UNKNOWN;
+    for (unsigned int i = 0; i < GL_STATE_TEXTURE_UNITS; i++) {
+        Textures[i] = GL_STATE_UNKNOWN;
+    }
+    Blend = -1;
+    BlendSource = BlendDestination = GL_STATE_UNKNOWN;
+}
+
+// Counts a state change as issued or skipped. Returns whether it has to be issued.
+bool GLState::Changed(bool changed) {
+    if (changed) {
+        Stats.Issued++;
+        METRIC_ADD(METRIC_STATE_CHANGES, 1);
+    } else {
+        Stats.Skipped++;
+    }
+    return changed;
+}
@@ -0,0 +1,56 @@
+/*
+ gl_state.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the GLState class
+ A singleton that tracks the bound OpenGL objects and skips state changes that would not change anything.
+ */
+
+#ifndef gl_state_hpp
+#define gl_state_hpp
+
+#include <glad/glad.h>
+
+const unsigned int GL_STATE_TEXTURE_UNITS = 4; // texture units whose bindings are tracked, later units are always bound
+
+// Numbers of state changes passed on to OpenGL and skipped since the stats were last reset
+struct GLStateStats {
+    unsigned long long Issued = 0;
+    unsigned long long Skipped = 0;
+};
+
+// All rendering code binds programs, textures, vertex arrays, array buffers and blend state through this class.
+// Objects are deleted through it as well, so that a deleted name reused by a new object is never mistaken as bound.
+class GLState {
+public:
+    static GLStateStats Stats;
+    
+    static void UseProgram(unsigned int program);
+    static void ActiveTexture(GLenum unit);
+    static void BindTexture(unsigned int texture);
+    static void BindVertexArray(unsigned int vao);
+    static void BindBuffer(GLenum target, unsigned int buffer);
+    static void SetBlend(bool enabled);
+    static void BlendFunc(GLenum source, GLenum destination);
+    static void DeleteProgram(unsigned int program);
+    static void DeleteTexture(unsigned int texture);
+    static void DeleteVertexArray(unsigned int vao);
+    static void DeleteBuffer(unsigned int buffer);
+    static void Invalidate();
+    
+private:
+    static unsigned int Program;
+    static unsigned int Unit; // index of the active texture unit
+    static unsigned int Textures[GL_STATE_TEXTURE_UNITS]; // GL_TEXTURE_2D binding of each tracked unit
+    static unsigned int VAO;
+    static unsigned int ArrayBuffer;
+    static int Blend; // 1 if enabled, 0 if disabled, -1 if unknown
+    static GLenum BlendSource;
+    static GLenum BlendDestination;
+    
+    GLState() {}
+    static bool Changed(bool changed);
+};
+
+#endif /* gl_state_hpp */
@@ -0,0 +1,279 @@
+/*
+ metrics.cpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Implementation of the Metrics class
+ A singleton that counts what the game does in each frame and exports the counts in the Prometheus text format.
+ */
+
+#include "metrics.hpp"
+#include "alloc_tracker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// Name, description and kind of each metric, in the order of the Metric enum
+struct MetricInfo {
+    const char *Name;
+    const char *Help;
+    bool Gauge;
+};
+
+static const MetricInfo METRIC_INFO[METRIC_COUNT] = {
+    {"draw_calls", "Draw calls issued", false},
+    {"state_changes", "OpenGL state changes passed on by the state cache", false},
+    {"uniform_uploads", "Uniform values uploaded", false},
+    {"uploaded_bytes", "Bytes of vertex, instance and glyph data uploaded while rendering", false},
+    {"stream_buffer_growths", "Times the stream buffer ran out of space and was replaced by a larger one", false},
+    {"collision_tests", "Collision tests run by the simulation", false},
+    {"collision_hits", "Collision tests that found a collision", false},
+    {"game_events", "Gameplay events handled by the simulation", false},
+    {"heap_allocations", "Heap allocations made by the game", false},
+    {"live_particles", "Particles drawn in the last frame", true},
+    {"active_powerups", "Powerup effects active at the end of the last frame", true}
+};
+
+// Instantiate static variables
+bool Metrics::Enabled = false;
+std::atomic<unsigned long long> Metrics::Current[METRIC_COUNT] = {};
+unsigned long long Metrics::Totals[METRIC_COUNT] = {};
+MetricsFrame Metrics::Frames[METRICS_FRAMES];
+std::atomic<unsigned long long> Metrics::FrameCount(0);
+std::atomic<bool> Metrics::Running(false);
+std::thread Metrics::Exporter;
+std::string Metrics::FilePath;
+int Metrics::Socket = -1;
+unsigned long long Metrics::Allocations = 0;
+
+// Starts exporting metrics to a file, to scrapers on a localhost port, or both. Does nothing if neither is given.
+// Must be called before any other thread starts. Returns false if the port cannot be opened.
+bool Metrics::Start(const std::string &filePath, int port) {
+    if (filePath.empty() && port <= 0) {
+        return true;
+    }
+    FilePath = filePath;
+    if (port > 0) {
+#ifdef _WIN32
+        std::cout << "ERROR::METRICS: Serving metrics is not supported on this platform" << std::endl;
+        return false;
+#else
+        Socket = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons((unsigned short)port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // only local scrapers may connect
+        if (Socket < 0 || bind(Socket, (sockaddr*)&address, sizeof(address)) != 0 || listen(Socket, 4) != 0) {
+            std::cout << "ERROR::METRICS: Could not listen on port " << port << std::endl;
+            if (Socket >= 0) {
+                close(Socket);
+                Socket = -1;
+            }
+            return false;
+        }
+#endif
+    }
+    Enabled = true;
+    AllocationTracker::Enabled = true;
+    Allocations = AllocationTracker::Count();
+    Running = true;
+    Exporter = std::thread(&Metrics::RunExporter);
+    return true;
+}
+
+// Publishes the counts of the frame that just ended to the ring and starts counting the next one. Called by the render thread.
+// Counts made on the simulation thread go to the frame during which they were made.
+void Metrics::EndFrame() {
+    if (!Enabled) {
+        return;
+    }
+    unsigned long long allocations = AllocationTracker::Count();
+    Add(METRIC_HEAP_ALLOCATIONS, allocations - Allocations);
+    Allocations = allocations;
+    unsigned long long frame = FrameCount.load(std::memory_order_relaxed);
+    MetricsFrame &slot = Frames[frame % METRICS_FRAMES];
+    slot.Sequence.store(frame * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (unsigned int i = 0; i < METRIC_COUNT; i++) {
+        unsigned long long value;
+        if (METRIC_INFO[i].Gauge) {
+            value = Current[i].load(std::memory_order_relaxed);
+            Totals[i] = value;
+        } else {
+            value = Current[i].exchange(0, std::memory_order_relaxed);
+            Totals[i] += value;
+        }
+        slot.Values[i].store(value, std::memory_order_relaxed);
+        slot.Totals[i].store(Totals[i], std::memory_order_relaxed);
+    }
+    slot.Sequence.store(frame * 2 + 2, std::memory_order_release);
+    FrameCount.store(frame + 1, std::memory_order_release);
+}
+
+// Stops the exporter after a last export. Called at program termination.
+void Metrics::Stop() {
+    if (!Running) {
+        return;
+    }
+    Running = false;
+    Exporter.join();
+#ifndef _WIN32
+    if (Socket >= 0) {
+        close(Socket);
+        Socket = -1;
+    }
+#endif
+}
+
+// Formats the ring once per export interval and writes the result or hands it to scrapers until stopped
+void Metrics::RunExporter() {
+    AllocationPause pause; // the exporter's own allocations are left out of the heap allocation count
+    unsigned long long lastFrame = 0;
+    std::string text = Format(lastFrame);
+    auto nextExport = std::chrono::steady_clock::now();
+    while (Running.load(std::memory_order_acquire)) {
+        if (std::chrono::steady_clock::now() >= nextExport) {
+            text = Format(lastFrame);
+            if (!FilePath.empty()) {
+                WriteFile(text);
+            }
+            nextExport += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(METRICS_EXPORT_INTERVAL));
+        }
+        if (Socket >= 0) {
+            Serve(text);
+        } else {
+            std::this_thread::sleep_for(std::chrono::duration<double>(METRICS_POLL_INTERVAL));
+        }
+    }
+    if (!FilePath.empty()) {
+        WriteFile(Format(lastFrame));
+    }
+}
+
+// Returns the metrics in the Prometheus text exposition format
+// Counters are exported as totals, along with the most counted in a single frame since the last export
+std::string Metrics::Format(unsigned long long &lastFrame) {
+    unsigned long long frameCount = FrameCount.load(std::memory_order_acquire);
+    unsigned long long first = frameCount > METRICS_FRAMES ? frameCount - METRICS_FRAMES : 0;
+    unsigned long long latest[METRIC_COUNT] = {};
+    unsigned long long maxima[METRIC_COUNT] = {};
+    bool latestRead = false;
+    for (unsigned long long frame = frameCount; frame-- > first;) {
+        // frames are read newest first, until a consistent frame has been found and all frames since the last export are seen
+        if (latestRead && frame < lastFrame) {
+            break;
+        }
+        MetricsFrame &slot = Frames[frame % METRICS_FRAMES];
+        unsigned long long sequence = slot.Sequence.load(std::memory_order_acquire);
+        if (sequence != frame * 2 + 2) {
+            continue;
+        }
+        unsigned long long values[METRIC_COUNT], totals[METRIC_COUNT];
+        for (unsigned int i = 0; i < METRIC_COUNT; i++) {
+            values[i] = slot.Values[i].load(std::memory_order_relaxed);
+            totals[i] = slot.Totals[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.Sequence.load(std::memory_order_relaxed) != sequence) {
+            continue; // the render thread overwrote the frame while it was read
+        }
+        if (!latestRead) {
+            std::copy(totals, totals + METRIC_COUNT, latest);
+            latestRead = true;
+        }
+        if (frame >= lastFrame) {
+            for (unsigned int i = 0; i < METRIC_COUNT; i++) {
+                maxima[i] = std::max(maxima[i], values[i]);
+            }
+        }
+    }
+    lastFrame = frameCount;
+
+    std::ostringstream text;
+    text << "# HELP breakout_frames_total Frames rendered\n# TYPE breakout_frames_total counter\nbreakout_frames_total " << frameCount << "\n";
+    for (unsigned int i = 0; i < METRIC_COUNT; i++) {
+        const MetricInfo &info = METRIC_INFO[i];
+        if (info.Gauge) {
+            text << "# HELP breakout_" << info.Name << " " << info.Help << "\n";
+            text << "# TYPE breakout_" << info.Name << " gauge\n";
+            text << "breakout_" << info.Name << " " << latest[i] << "\n";
+        } else {
+            text << "# HELP breakout_" << info.Name << "_total " << info.Help << "\n";
+            text << "# TYPE breakout_" << info.Name << "_total counter\n";
+            text << "breakout_" << info.Name << "_total " << latest[i] << "\n";
+            text << "# HELP breakout_" << info.Name << "_per_frame_max " << info.Help << " in the busiest frame since the last export\n";
+            text << "# TYPE breakout_" << info.Name << "_per_frame_max gauge\n";
+            text << "breakout_" << info.Name << "_per_frame_max " << maxima[i] << "\n";
+        }
+    }
+    return text.str();
+}
+
+// Replaces the metrics file. The text is written to a temporary file first, so that a reader never sees a partial export.
+bool Metrics::WriteFile(const std::string &text) {
+    std::string temporaryPath = FilePath + ".tmp";
+    FILE *file = fopen(temporaryPath.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::METRICS: Could not write " << temporaryPath << std::endl;
+        return false;
+    }
+    bool written = fwrite(text.data(), 1, text.size(), file) == text.size();
+    written = fclose(file) == 0 && written;
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(temporaryPath, FilePath, error); // replaces the old export atomically, so it never goes missing
+    }
+    if (!written || error) {
+        std::cout << "ERROR::METRICS: Could not write " << FilePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Waits up to a poll interval for a scraper and answers its HTTP request with the latest export
+void Metrics::Serve(const std::string &text) {
+#ifndef _WIN32
+    fd_set sockets;
+    FD_ZERO(&sockets);
+    FD_SET(Socket, &sockets);
+    timeval timeout = {0, (int)(METRICS_POLL_INTERVAL * 1e6)};
+    if (select(Socket + 1, &sockets, nullptr, nullptr, &timeout) <= 0) {
+        return;
+    }
+    int client = accept(Socket, nullptr, nullptr);
+    if (client < 0) {
+        return;
+    }
+    // the request is read but not parsed, every path returns the metrics. A silent client is given up on after a second.
+    timeval receiveTimeout = {1, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout));
+#ifdef SO_NOSIGPIPE
+    int noSignal = 1;
+    setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+#endif
+    char request[1024];
+    recv(client, request, sizeof(request), 0);
+    std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + std::to_string(text.size()) + "\r\nConnection: close\r\n\r\n" + text;
+#ifdef MSG_NOSIGNAL
+    send(client, response.data(), response.size(), MSG_NOSIGNAL);
+#else
+    send(client, response.data(), response.size(), 0);
+#endif
+    close(client);
+#endif
+}
@@ -0,0 +1,75 @@
+/*
+ metrics.hpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Declaration of the Metrics class
+ A singleton that counts what the game does in each frame and exports the counts in the Prometheus text format.
+ */
+
+#ifndef metrics_hpp
+#define metrics_hpp
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+const unsigned int METRICS_FRAMES = 256; // frames kept in the ring, the exporter skips frames overwritten before it read them
+const double METRICS_EXPORT_INTERVAL = 1.0; // seconds between two exports
+const double METRICS_POLL_INTERVAL = 0.1; // seconds the exporter waits for a scrape before checking whether it should stop
+
+enum Metric {
+    METRIC_DRAW_CALLS,
+    METRIC_STATE_CHANGES, // OpenGL state changes passed on by the state cache
+    METRIC_UNIFORM_UPLOADS,
+    METRIC_UPLOADED_BYTES, // vertex, instance and glyph data uploaded while rendering
+    METRIC_STREAM_GROWTHS, // frames that ran out of stream buffer space and moved to a larger buffer
+    METRIC_COLLISION_TESTS,
+    METRIC_COLLISION_HITS,
+    METRIC_GAME_EVENTS, // gameplay events handled by the simulation
+    METRIC_HEAP_ALLOCATIONS,
+    METRIC_LIVE_PARTICLES, // gauge, set once per frame
+    METRIC_ACTIVE_POWERUPS, // gauge, set once per simulation step
+    METRIC_COUNT
+};
+
+// A finished frame in the ring. The sequence is odd while the render thread writes the frame, so a reader can tell a torn read.
+struct MetricsFrame {
+    std::atomic<unsigned long long> Sequence;
+    std::atomic<unsigned long long> Values[METRIC_COUNT]; // counts of the frame, or the value of a gauge at its end
+    std::atomic<unsigned long long> Totals[METRIC_COUNT]; // counts since the game started
+};
+
+class Metrics {
+public:
+    static bool Enabled; // set before any other thread starts and never changed afterwards
+
+    static void Add(Metric metric, unsigned long long value) { Current[metric].fetch_add(value, std::memory_order_relaxed); }
+    static void Set(Metric metric, unsigned long long value) { Current[metric].store(value, std::memory_order_relaxed); }
+    static bool Start(const std::string &filePath, int port);
+    static void EndFrame();
+    static void Stop();
+
+private:
+    static std::atomic<unsigned long long> Current[METRIC_COUNT]; // counts of the current frame, added to from any thread
+    static unsigned long long Totals[METRIC_COUNT]; // only used by the render thread
+    static MetricsFrame Frames[METRICS_FRAMES];
+    static std::atomic<unsigned long long> FrameCount; // frames published to the ring
+    static std::atomic<bool> Running;
+    static std::thread Exporter;
+    static std::string FilePath; // empty unless metrics are written to a file
+    static int Socket; // listening socket, or -1 unless metrics are served to scrapers
+    static unsigned long long Allocations; // allocation count of the tracker at the end of the last frame
+
+    Metrics() {}
+    static void RunExporter();
+    static std::string Format(unsigned long long &lastFrame);
+    static bool WriteFile(const std::string &text);
+    static void Serve(const std::string &text);
+};
+
+// Counters compile to a single check of a flag that never changes while metrics are disabled
+#define METRIC_ADD(metric, value) do { if (Metrics::Enabled) Metrics::Add(metric, value); } while (0)
+#define METRIC_SET(metric, value) do { if (Metrics::Enabled) Metrics::Set(metric, value); } while (0)
+
+#endif /* metrics_hpp */
@@ -1,22 +1,26 @@
 /*
  particle_generator.cpp
  Breakout
- Last updated on October 3, 2020
+ Last updated on October 19, 2026
  
  Implementation of the ParticleGenerator class
  A singleton class responsible for particle effects
  */
 
 #include "particle_generator.hpp"
+#include "gl_state.hpp"
+#include "profiler.hpp"
+#include "metrics.hpp"
 
-#include <string>
+#include <cstddef>
 
-ParticleGenerator::ParticleGenerator(Shader &shader, Texture2D &texture, unsigned int count) : ParticleShader(shader), ParticleTexture(texture), Count(count) {
+ParticleGenerator::ParticleGenerator(Shader &shader, Texture2D &texture, unsigned int count, StreamBuffer &stream) : ParticleShader(shader), ParticleTexture(texture), Count(count), Stream(&stream) {
     Init();
 }
 
 // Called each frame to replace dead particles and update status of remaining particles
-void ParticleGenerator::Update(float dt, GameObject &object, unsigned int countNew, glm::vec2 offset) {
+void ParticleGenerator::Update(float dt, const GameObject &object, unsigned int countNew, glm::vec2 offset) {
+    PROFILE_ZONE("Particles");
     // respawn a given number of particles
     for (unsigned int i = 0; i < countNew; i++) {
         int fillInd = GetEmptySpot();
@@ -33,26 +37,33 @@ void ParticleGenerator::Update(float dt, GameObject &object, unsigned int countN
     }
 }
 
-// Called each frame after Update to render particles
-// Instanced rendering is used to improve efficiency
-void ParticleGenerator::Render() {
-    unsigned int numActive = 0;
+// Called each frame after Update to record the live particles in a render queue
+// Instanced rendering is used to improve efficiency. The instances are written straight into the stream buffer.
+void ParticleGenerator::Render(RenderQueue &queue) {
+    GLsizei numActive = 0;
+    for (Particle &particle : Particles) {
+        numActive += particle.Life > 0.0f;
+    }
+    METRIC_SET(METRIC_LIVE_PARTICLES, numActive);
+    GLintptr offset;
+    ParticleInstance *instances = numActive ? (ParticleInstance*)Stream->Allocate(numActive * sizeof(ParticleInstance), sizeof(float), offset) : nullptr;
+    if (!instances) {
+        return;
+    }
     for (Particle &particle : Particles) {
         if (particle.Life > 0.0f) {
-            numActive++;
-            ParticleShader.setVec2("offsets["+std::to_string(numActive-1)+"]", particle.Position);
-            ParticleShader.setVec4("colors["+std::to_string(numActive-1)+"]", particle.Color);
+            *instances++ = {particle.Position, particle.Color};
         }
     }
     
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE); // particles are rendered additively on top of the scene
-    ParticleShader.Use();
-    glActiveTexture(0);
-    ParticleTexture.Bind();
-    glBindVertexArray(VAO);
-    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, numActive);
-    glBindVertexArray(0);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // reset blend mode
+    // the instance attributes are pointed at this frame's instances, as the VAO is drawn once per frame
+    GLState::BindVertexArray(VAO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, Stream->ID);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)(offset + offsetof(ParticleInstance, Offset)));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)(offset + offsetof(ParticleInstance, Color)));
+    
+    // particles are rendered additively on top of the scene
+    queue.Add(LAYER_PARTICLES, ParticleShader, ParticleTexture.ID, BLEND_ADDITIVE, VAO, GL_TRIANGLE_STRIP, 0, 4, numActive);
 }
 
 // Initiates Particles array and fills VAO. Particles are rendered as tiny colored squares.
@@ -66,16 +77,21 @@ void ParticleGenerator::Init() {
     
     unsigned int VBO;
     glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    GLState::BindVertexArray(VAO);
     glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // offset and color of each instance, pointed at the stream buffer by Render
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
     
     for (unsigned int i = 0; i < Count; i++) {
         Particles.push_back(Particle());
@@ -104,7 +120,7 @@ unsigned int ParticleGenerator::GetEmptySpot() {
 }
 
 // Spawn a particle that adheres to a game object
-void ParticleGenerator::RespawnParticle(Particle &particle, GameObject &object, glm::vec2 offset) {
+void ParticleGenerator::RespawnParticle(Particle &particle, const GameObject &object, glm::vec2 offset) {
     float random = (rand() % 100 - 50) / 10.0f;
     float rColor = 0.5f + rand() % 100 / 100.0f;
     particle.Position = object.Position + random + offset;
@@ -1,7 +1,7 @@
 /*
  particle_generator.hpp
  Breakout
- Last updated on October 3, 2020
+ Last updated on October 19, 2026
  
  Declaration of the ParticleGenerator class
  A singleton class responsible for particle effects
@@ -18,6 +18,8 @@
 #include "shader.hpp"
 #include "texture.hpp"
 #include "game_object.hpp"
+#include "render_queue.hpp"
+#include "stream_buffer.hpp"
 
 // Definition of a particle
 struct Particle {
@@ -29,24 +31,33 @@ struct Particle {
     Particle() : Position(0.0f), Velocity(0.0f), Color(0.0f), Life(1.0f) {}
 };
 
+// Per-instance data of a live particle, written to the stream buffer each frame
+struct ParticleInstance {
+    glm::vec2 Offset;
+    glm::vec4 Color;
+};
+
 class ParticleGenerator {
 public:
-    ParticleGenerator(Shader &shader, Texture2D &texture, unsigned int count);
+    ParticleGenerator(Shader &shader, Texture2D &texture, unsigned int count, StreamBuffer &stream);
     
-    void Update(float dt, GameObject &object, unsigned int countNew, glm::vec2 offset = glm::vec2(0.0f));
-    void Render();
+    void Update(float dt, const GameObject &object, unsigned int countNew, glm::vec2 offset = glm::vec2(0.0f));
+    void Render(RenderQueue &queue);
     
 private:
+    friend struct MicrobenchAccess; // tools/microbench times GetEmptySpot on prepared particles
+    
     std::vector<Particle> Particles;
     unsigned int Count;
     Shader ParticleShader;
     Texture2D ParticleTexture;
     unsigned int VAO;
     unsigned int lastUsedIndex = 0;
+    StreamBuffer *Stream; // holds the instances of the live particles
     
     void Init();
     unsigned int GetEmptySpot();
-    void RespawnParticle(Particle &particle, GameObject &object, glm::vec2 offset = glm::vec2(0.0f));
+    void RespawnParticle(Particle &particle, const GameObject &object, glm::vec2 offset = glm::vec2(0.0f));
 };
 
 #endif /* particle_generator_hpp */
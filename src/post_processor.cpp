@@ -1,37 +1,121 @@
 /*
  post_processor.cpp
  Breakout
- Last updated on October 3, 2020
+ Last updated on October 19, 2026
  
  Implementation of the PostProcessor class
  A singleton class responsible for post-processing effects
  */
 
 #include "post_processor.hpp"
+#include "gl_state.hpp"
+#include "profiler.hpp"
+#include "metrics.hpp"
+#include "resource_manager.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <string>
 
 // The post processor works by temporarily storing render data in intermediate framebuffers and post-process the entire scene as a texture.
-PostProcessor::PostProcessor(Shader &shader, unsigned int width, unsigned int height, bool doubleRes) : PPShader(shader), Scene(), Width(width), Height(height), Chaos(false), Shake(false), Confuse(false) {
-    // framebuffer size is doubled if using a retina screen
-    if (doubleRes) {
-        Width *= 2;
-        Height *= 2;
+PostProcessor::PostProcessor(unsigned int screenWidth, unsigned int screenHeight, float renderScale, unsigned int samples) : Scene(), ScreenWidth(screenWidth), ScreenHeight(screenHeight), RenderScale(renderScale), Samples(samples), Chaos(false), Shake(false), Confuse(false) {
+    // the requested sample count is limited by what the driver supports
+    GLint maxSamples;
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    if (Samples > (unsigned int)maxSamples) {
+        std::cout << "WARNING::POSTPROCESSOR: " << Samples << "x MSAA is not supported, using " << maxSamples << "x" << std::endl;
+        Samples = maxSamples;
     }
     
     glGenFramebuffers(1, &MSFBO);
     glGenFramebuffers(1, &FBO);
     glGenRenderbuffers(1, &RBO);
+    InitFramebuffers();
+    InitRenderData();
+    InitVariants();
+}
+
+// Resizes the offscreen scene to follow the default framebuffer. Called when the window is resized.
+void PostProcessor::Resize(unsigned int screenWidth, unsigned int screenHeight) {
+    ScreenWidth = screenWidth;
+    ScreenHeight = screenHeight;
+    InitFramebuffers();
+}
+
+// Changes the resolution of the offscreen scene relative to the default framebuffer
+void PostProcessor::SetRenderScale(float renderScale) {
+    RenderScale = renderScale;
+    InitFramebuffers();
+}
+
+// Called before rendering the scene
+void PostProcessor::BeginRender() {
+    PROFILE_GPU_ZONE("Clear");
+    glBindFramebuffer(GL_FRAMEBUFFER, Samples > 0 ? MSFBO : FBO);
+    glViewport(0, 0, Width, Height);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+// Called after the scene is rendered
+void PostProcessor::EndRender() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Renders the post-processed scene to screen by running the pass chain of the current frame
+// Without active effects the scene is blitted to the default framebuffer and no shader pass is run
+void PostProcessor::RenderToScreen(float time) {
+    PROFILE_ZONE("Post-processing");
+    PROFILE_GPU_ZONE("Post-processing");
+    glViewport(0, 0, ScreenWidth, ScreenHeight);
+    BuildPassChain();
+    for (PostPass pass : Passes) {
+        switch (pass) {
+            case PASS_RESOLVE:
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, MSFBO);
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+                glBlitFramebuffer(0, 0, Width, Height, 0, 0, Width, Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+                break;
+            case PASS_BLIT_TO_SCREEN:
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+                glBlitFramebuffer(0, 0, Width, Height, 0, 0, ScreenWidth, ScreenHeight, GL_COLOR_BUFFER_BIT, (Width == ScreenWidth && Height == ScreenHeight) ? GL_NEAREST : GL_LINEAR);
+                break;
+            case PASS_EFFECTS: {
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                Shader &shader = Variants[ActiveEffects()];
+                shader.Use();
+                shader.setFloat("time", time);
+                GLState::ActiveTexture(GL_TEXTURE0);
+                Scene.Bind();
+                GLState::BindVertexArray(VAO);
+                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+                METRIC_ADD(METRIC_DRAW_CALLS, 1);
+                break;
+            }
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0); // bind back to default framebuffer
+}
+
+// (Re)allocates the storage of the offscreen framebuffers for the current screen size and render scale
+void PostProcessor::InitFramebuffers() {
+    Width = std::max(1u, (unsigned int)std::lround(ScreenWidth * RenderScale));
+    Height = std::max(1u, (unsigned int)std::lround(ScreenHeight * RenderScale));
     // initialize multi-sampled framebuffer to which the scene is rendered in the first pass
     // a multi-sampled FBO is used to guard against visible aliasing
-    glBindFramebuffer(GL_FRAMEBUFFER, MSFBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, RBO);
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGB, Width, Height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, RBO);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cout << "ERROR::POSTPROCESSOR: Failed to initialize MSFBO" << std::endl;
+    if (Samples > 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, MSFBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, RBO);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, Samples, GL_RGB, Width, Height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, RBO);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERROR::POSTPROCESSOR: Failed to initialize MSFBO" << std::endl;
+        }
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
     }
-    // initialize intermediate framebuffer to blit the MSFBO to
+    // initialize intermediate framebuffer to blit the MSFBO to, or to render to directly without multi-sampling
     glBindFramebuffer(GL_FRAMEBUFFER, FBO);
     Scene.Generate(Width, Height, NULL);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Scene.ID, 0); // scene will be stored in this->Scene
@@ -39,69 +123,51 @@ PostProcessor::PostProcessor(Shader &shader, unsigned int width, unsigned int he
         std::cout << "ERROR::POSTPROCESSOR: Failed to initialize intermediate FBO" << std::endl;
     }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    
-    InitRenderData();
-    PPShader.setInt("scene", 0);
-    // kernel sampling offsets
-    float offset = 1.0f / 300.0f;
-    glm::vec2 offsets[9] = {
-        glm::vec2(-offset, offset),
-        glm::vec2(0.0f, offset),
-        glm::vec2(offset, offset),
-        glm::vec2(-offset, 0.0f),
-        glm::vec2(0.0f, 0.0f),
-        glm::vec2(offset, 0.0f),
-        glm::vec2(-offset, -offset),
-        glm::vec2(0.0f, -offset),
-        glm::vec2(offset, -offset)
-    };
-    // kernel for edge detection effect
-    int edge_kernel[9] = {
-        -1, -1, -1,
-        -1, 8, -1,
-        -1, -1, -1
-    };
-    // kernel for blur effect
-    float blur_kernel[9] = {
-        1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
-        2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
-        1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f
-    };
-    for (unsigned int i = 0; i < 9; i++) {
-        PPShader.setVec2("offsets["+std::to_string(i)+"]", offsets[i]);
-        PPShader.setInt("edge_kernel["+std::to_string(i)+"]", edge_kernel[i]);
-        PPShader.setFloat("blur_kernel["+std::to_string(i)+"]", blur_kernel[i]);
+}
+
+// Compiles one shader variant for every combination of effects, unless they were loaded ahead of time
+void PostProcessor::InitVariants() {
+    for (unsigned int effects = 1; effects < PP_NUM_VARIANTS; effects++) {
+        Variants[effects] = ResourceManager::GetOrLoadShader("shaders/post_processing.vert", "shaders/post_processing.frag", nullptr, VariantName(effects), VariantDefines(effects));
+        Variants[effects].setInt("scene", 0);
     }
 }
 
-// Called before rendering the scene
-void PostProcessor::BeginRender() {
-    glBindFramebuffer(GL_FRAMEBUFFER, MSFBO);
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+// Returns the name under which the variant of a combination of effects is stored in the ResourceManager
+std::string PostProcessor::VariantName(unsigned int effects) {
+    return "shaderPP" + std::to_string(effects);
 }
 
-// Called after the scene is rendered
-void PostProcessor::EndRender() {
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, MSFBO);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
-    glBlitFramebuffer(0, 0, Width, Height, 0, 0, Width, Height, GL_COLOR_BUFFER_BIT, GL_NEAREST); // blit MSFBO to FBO
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+// Returns the preprocessor definitions that select a combination of effects in the post-processing shaders
+std::string PostProcessor::VariantDefines(unsigned int effects) {
+    std::string defines;
+    if (effects & PP_CHAOS) {
+        defines += "#define CHAOS\n";
+    }
+    if (effects & PP_CONFUSE) {
+        defines += "#define CONFUSE\n";
+    }
+    if (effects & PP_SHAKE) {
+        defines += "#define SHAKE\n";
+    }
+    return defines;
 }
 
-// Renders the post-processed scene to screen
-void PostProcessor::RenderToScreen(float time) {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); // bind back to default framebuffer
-    PPShader.Use();
-    PPShader.setFloat("time", time);
-    PPShader.setInt("chaos", Chaos);
-    PPShader.setInt("confuse", Confuse);
-    PPShader.setInt("shake", Shake);
-    glActiveTexture(GL_TEXTURE0);
-    Scene.Bind();
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);
+// Returns the effect bits of the effects that are currently enabled
+unsigned int PostProcessor::ActiveEffects() const {
+    return (Chaos ? PP_CHAOS : 0) | (Confuse ? PP_CONFUSE : 0) | (Shake ? PP_SHAKE : 0);
+}
+
+// Decides which passes the current frame needs
+// Without multi-sampling the scene is already stored in the Scene texture and needs no resolve
+// A multi-sampled scene is always resolved into the Scene texture, whose format matches it, rather than straight into the
+// default framebuffer, whose format is up to the driver and may differ, which makes the resolve fail
+void PostProcessor::BuildPassChain() {
+    Passes.clear();
+    if (Samples > 0) {
+        Passes.push_back(PASS_RESOLVE);
+    }
+    Passes.push_back(ActiveEffects() != 0 ? PASS_EFFECTS : PASS_BLIT_TO_SCREEN);
 }
 
 // Fills VBO and VAO
@@ -115,14 +181,14 @@ void PostProcessor::InitRenderData() {
     
     unsigned int VBO;
     glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    GLState::BindVertexArray(VAO);
     glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
 }
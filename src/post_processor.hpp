@@ -1,7 +1,7 @@
 /*
  post_processor.hpp
  Breakout
- Last updated on October 3, 2020
+ Last updated on October 19, 2026
  
  Declaration of the PostProcessor class
  A singleton class responsible for post-processing effects
@@ -13,33 +13,62 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <string>
+#include <vector>
+
 #include "texture.hpp"
 #include "sprite_renderer.hpp"
 #include "shader.hpp"
 
+// Effect bits. A combination of them indexes the shader variant compiled for exactly those effects.
+const unsigned int PP_CHAOS = 1;
+const unsigned int PP_CONFUSE = 2;
+const unsigned int PP_SHAKE = 4;
+const unsigned int PP_NUM_VARIANTS = 8;
+
+// Passes of the post-processing chain. Only the passes needed by the current frame are run.
+enum PostPass {
+    PASS_RESOLVE, // resolves the multi-sampled scene into the Scene texture
+    PASS_BLIT_TO_SCREEN, // copies the Scene texture into the default framebuffer, scaling it if needed
+    PASS_EFFECTS // renders the Scene texture to the default framebuffer with the variant of the active effects
+};
+
 class PostProcessor {
 public:
-    Shader PPShader;
+    Shader Variants[PP_NUM_VARIANTS]; // one shader per effect combination. Variant 0 (no effect) is never used.
     Texture2D Scene; // the entire game scene stored in a texture
-    unsigned int Width;
+    unsigned int Width; // size of the offscreen scene in pixels
     unsigned int Height;
+    unsigned int ScreenWidth; // size of the default framebuffer
+    unsigned int ScreenHeight;
+    float RenderScale; // size of the offscreen scene relative to the default framebuffer
+    unsigned int Samples; // number of MSAA samples, 0 renders the scene without multi-sampling
     bool Confuse; // the confuse effect rotates the scene by 180 degrees
     bool Shake; // the shake effect shakes the scene periodically
     bool Chaos; // the chaos effect heavily distorts the scene
     
-    PostProcessor(Shader &shader, unsigned int width, unsigned int height, bool doubleRes);
+    PostProcessor(unsigned int screenWidth, unsigned int screenHeight, float renderScale, unsigned int samples);
     
+    void Resize(unsigned int screenWidth, unsigned int screenHeight);
+    void SetRenderScale(float renderScale);
     void BeginRender();
     void EndRender();
     void RenderToScreen(float time);
+    static std::string VariantName(unsigned int effects);
+    static std::string VariantDefines(unsigned int effects);
     
 private:
     unsigned int FBO;
-    unsigned int MSFBO; // multi-sampled framebuffer
+    unsigned int MSFBO; // multi-sampled framebuffer, unused if Samples is 0
     unsigned int RBO;
     unsigned int VAO;
+    std::vector<PostPass> Passes; // pass chain of the current frame
     
+    void InitFramebuffers();
     void InitRenderData();
+    void InitVariants();
+    unsigned int ActiveEffects() const;
+    void BuildPassChain();
 };
 
 #endif /* post_processor_hpp */
@@ -1,14 +1,92 @@
 /*
  power_up.cpp
  Breakout
- Last updated on October 1, 2020
+ Last updated on October 19, 2026
  
- Implementation of the PowerUp class
- The PowerUp class inherits the Gameobject class, defining collectable powerups that introduce special effects in the game.
+ Implementation of the PowerUpPool class
+ Defines collectable powerups that introduce special effects in the game, and the fixed-capacity pool storing them.
  */
 
 #include "power_up.hpp"
 
-PowerUp::PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position, Texture2D &texture) : GameObject(position, POWERUP_SIZE, texture, color, false), Type(type), Duration(duration), Active(false) {
-    Velocity = POWERUP_V0;
+PowerUpPool::PowerUpPool(unsigned int capacity) : Dropped(0), Slots(capacity), Infos(capacity, {POWERUP_FREE, 1, 0}) {
+    FreeList.reserve(capacity);
+    FallingList.reserve(capacity);
+    ActiveList.reserve(capacity);
+    for (unsigned int slot = capacity; slot-- > 0;) {
+        FreeList.push_back(slot); // slots are handed out from the front of the pool first
+    }
+}
+
+// Adds a falling powerup and returns its handle, or an invalid handle if the pool is full
+PowerUpHandle PowerUpPool::Spawn(PowerUpType type, glm::vec2 position) {
+    if (FreeList.empty()) {
+        Dropped++;
+        return PowerUpHandle();
+    }
+    unsigned int slot = FreeList.back();
+    FreeList.pop_back();
+    Slots[slot] = {type, position, TimerHandle()};
+    Infos[slot].State = POWERUP_FALLING;
+    Infos[slot].ListIndex = (unsigned int)FallingList.size();
+    FallingList.push_back(slot);
+    return Handle(slot);
+}
+
+// Returns the powerup a handle refers to, or null if it has been released
+PowerUp *PowerUpPool::Get(PowerUpHandle handle) {
+    if (handle.Index >= Slots.size() || Infos[handle.Index].Generation != handle.Generation || Infos[handle.Index].State == POWERUP_FREE) {
+        return nullptr;
+    }
+    return &Slots[handle.Index];
+}
+
+// Returns a handle to the powerup in a slot in use
+PowerUpHandle PowerUpPool::Handle(unsigned int slot) const {
+    PowerUpHandle handle;
+    handle.Index = slot;
+    handle.Generation = Infos[slot].Generation;
+    return handle;
+}
+
+// Moves a collected powerup from the falling list to the active list
+void PowerUpPool::Activate(unsigned int slot) {
+    if (Infos[slot].State != POWERUP_FALLING) {
+        return;
+    }
+    Unlist(slot);
+    Infos[slot].State = POWERUP_ACTIVE;
+    Infos[slot].ListIndex = (unsigned int)ActiveList.size();
+    ActiveList.push_back(slot);
+}
+
+// Returns a powerup's slot to the pool, invalidating its handles
+void PowerUpPool::Release(unsigned int slot) {
+    if (Infos[slot].State == POWERUP_FREE) {
+        return;
+    }
+    Unlist(slot);
+    Infos[slot].State = POWERUP_FREE;
+    Infos[slot].Generation = Infos[slot].Generation + 1 ? Infos[slot].Generation + 1 : 1;
+    FreeList.push_back(slot);
+}
+
+// Releases all powerups
+void PowerUpPool::Clear() {
+    while (!FallingList.empty()) {
+        Release(FallingList.back());
+    }
+    while (!ActiveList.empty()) {
+        Release(ActiveList.back());
+    }
+}
+
+// Removes a slot from the list of its state by moving the list's last entry into its place
+void PowerUpPool::Unlist(unsigned int slot) {
+    std::vector<unsigned int> &list = List(Infos[slot].State);
+    unsigned int index = Infos[slot].ListIndex;
+    unsigned int last = list.back();
+    list[index] = last;
+    Infos[last].ListIndex = index;
+    list.pop_back();
 }
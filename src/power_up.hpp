@@ -1,10 +1,10 @@
 /*
  power_up.hpp
  Breakout
- Last updated on October 1, 2020
+ Last updated on October 19, 2026
  
- Declaration of the PowerUp class
- The PowerUp class inherits the Gameobject class, defining collectable powerups that introduce special effects in the game.
+ Declaration of the PowerUp struct and the PowerUpPool class
+ Defines collectable powerups that introduce special effects in the game, and the fixed-capacity pool storing them.
  */
 
 #ifndef power_up_hpp
@@ -13,20 +13,89 @@
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
-#include <string>
+#include <vector>
 
-#include "game_object.hpp"
+#include "timer_wheel.hpp"
 
 const glm::vec2 POWERUP_SIZE(60.0f, 20.0f);
-const glm::vec2 POWERUP_V0(0.0f, 150.0f); // downward initial velocity
+const glm::vec2 POWERUP_V0(0.0f, 150.0f); // downward velocity
+const unsigned int POWERUP_POOL_CAPACITY = 4096; // powerups falling or active at once, further spawns are dropped
 
-class PowerUp : public GameObject {
+enum PowerUpType {
+    POWERUP_SPEED,
+    POWERUP_STICKY,
+    POWERUP_PASS_THROUGH,
+    POWERUP_PAD_SIZE_INCREASE,
+    POWERUP_CONFUSE,
+    POWERUP_CHAOS,
+    NUM_POWERUP_TYPES
+};
+
+// color and effect duration in seconds of each type of powerup, indexed by PowerUpType
+const glm::vec3 POWERUP_COLORS[NUM_POWERUP_TYPES] = {
+    glm::vec3(0.5f, 0.5f, 1.0f),
+    glm::vec3(1.0f, 0.5f, 1.0f),
+    glm::vec3(0.5f, 1.0f, 0.5f),
+    glm::vec3(1.0f, 0.6f, 0.4f),
+    glm::vec3(1.0f, 0.3f, 0.3f),
+    glm::vec3(0.9f, 0.25f, 0.25f)
+};
+const float POWERUP_DURATIONS[NUM_POWERUP_TYPES] = {0.0f, 5.0f, 3.0f, 3.0f, 3.0f, 3.0f};
+
+// A powerup falling towards the paddle or, once collected, an active effect. Its size, color, texture and duration follow from its type.
+struct PowerUp {
+    PowerUpType Type;
+    glm::vec2 Position;
+    TimerHandle Expiry; // ends the effect once collected
+};
+
+// Refers to a powerup for as long as it stays in the pool. A handle to a released powerup no longer resolves, even once its slot is reused.
+struct PowerUpHandle {
+    unsigned int Index = 0;
+    unsigned int Generation = 0; // 0 is never valid
+};
+
+enum PowerUpState {
+    POWERUP_FREE,
+    POWERUP_FALLING,
+    POWERUP_ACTIVE
+};
+
+// All storage is allocated up front. Powerups never move between slots, and each slot in use is listed in either the falling
+// or the active list. The lists are kept compact by moving the last entry into a removed one, so spawning, collecting and
+// releasing are O(1) and never allocate. Removing while iterating a list is safe when iterating from its end.
+class PowerUpPool {
 public:
-    std::string Type;
-    float Duration;
-    bool Active;
+    unsigned long long Dropped; // spawns dropped because the pool was full
+    
+    PowerUpPool(unsigned int capacity = POWERUP_POOL_CAPACITY);
+    
+    PowerUpHandle Spawn(PowerUpType type, glm::vec2 position);
+    PowerUp *Get(PowerUpHandle handle);
+    PowerUpHandle Handle(unsigned int slot) const;
+    PowerUp &Slot(unsigned int slot) { return Slots[slot]; }
+    const std::vector<unsigned int> &Falling() const { return FallingList; }
+    const std::vector<unsigned int> &Active() const { return ActiveList; }
+    void Activate(unsigned int slot);
+    void Release(unsigned int slot);
+    void Clear();
+    
+private:
+    // bookkeeping of a slot, kept apart from the powerups so that updates only touch the powerups themselves
+    struct SlotInfo {
+        PowerUpState State;
+        unsigned int Generation;
+        unsigned int ListIndex; // position of the slot in the list of its state
+    };
+    
+    std::vector<PowerUp> Slots;
+    std::vector<SlotInfo> Infos;
+    std::vector<unsigned int> FreeList; // free slots, the most recently released last
+    std::vector<unsigned int> FallingList;
+    std::vector<unsigned int> ActiveList;
     
-    PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position, Texture2D &texture);
+    std::vector<unsigned int> &List(PowerUpState state) { return state == POWERUP_FALLING ? FallingList : ActiveList; }
+    void Unlist(unsigned int slot);
 };
 
 #endif /* power_up_hpp */
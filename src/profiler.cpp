@@ -0,0 +1,225 @@
+/*
+ profiler.cpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Implementation of the Profiler class
+ A singleton that times scoped zones on the CPU and the GPU, shows them in an overlay and exports them as a Chrome trace.
+ */
+
+#include "profiler.hpp"
+#include "text_renderer.hpp"
+#include "alloc_tracker.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// Instantiate static variables
+bool Profiler::Overlay = false;
+std::atomic<bool> Profiler::Recording(false);
+std::mutex Profiler::Lock;
+std::vector<ZoneStats> Profiler::Stats;
+std::vector<ProfileEvent> Profiler::Trace;
+std::vector<std::string> Profiler::ThreadNames;
+std::string Profiler::TracePath;
+double Profiler::IntervalStart = 0.0;
+unsigned int Profiler::Frame = 0;
+unsigned int Profiler::GpuQueries[PROFILER_GPU_FRAMES][PROFILER_GPU_ZONES] = {};
+ProfileEvent Profiler::GpuZones[PROFILER_GPU_FRAMES][PROFILER_GPU_ZONES];
+unsigned int Profiler::GpuZoneCount[PROFILER_GPU_FRAMES] = {};
+unsigned int Profiler::GpuZoneDepth = 0;
+bool Profiler::GpuZoneOpen = false;
+
+// Returns the microseconds passed since the profiler was first used
+double Profiler::Now() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Shows or hides the overlay
+void Profiler::ToggleOverlay() {
+    Overlay = !Overlay;
+    UpdateRecording();
+}
+
+// Names the calling thread in the trace
+void Profiler::SetThreadName(const char *name) {
+    unsigned int index = ThreadIndex();
+    std::lock_guard<std::mutex> guard(Lock);
+    ThreadNames[index] = name;
+}
+
+// Records all zones from now on and writes them to a Chrome trace file when the profiler is cleaned up
+void Profiler::StartTrace(const std::string &path) {
+    std::lock_guard<std::mutex> guard(Lock);
+    TracePath = path;
+    Trace.reserve(PROFILER_MAX_TRACE_EVENTS / 16);
+    UpdateRecording();
+}
+
+// Collects the GPU zones whose queries were issued PROFILER_GPU_FRAMES frames ago and reuses their queries
+// Also averages the zones once per overlay interval. Called at the start of each frame by the thread owning the OpenGL context.
+void Profiler::BeginFrame() {
+    if (!GpuQueries[0][0]) {
+        glGenQueries(PROFILER_GPU_FRAMES * PROFILER_GPU_ZONES, &GpuQueries[0][0]);
+    }
+    Frame++;
+    unsigned int slot = Frame % PROFILER_GPU_FRAMES;
+    for (unsigned int i = 0; i < GpuZoneCount[slot]; i++) {
+        // a result that is still not available is dropped rather than waited for
+        GLint available = 0;
+        glGetQueryObjectiv(GpuQueries[slot][i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsed;
+            glGetQueryObjectui64v(GpuQueries[slot][i], GL_QUERY_RESULT, &elapsed);
+            ProfileEvent &event = GpuZones[slot][i];
+            event.Duration = elapsed / 1000.0;
+            std::lock_guard<std::mutex> guard(Lock);
+            AddEvent(event);
+        }
+    }
+    GpuZoneCount[slot] = 0;
+
+    double now = Now();
+    if (now - IntervalStart >= PROFILER_OVERLAY_INTERVAL * 1e6) {
+        std::lock_guard<std::mutex> guard(Lock);
+        double seconds = (now - IntervalStart) / 1e6;
+        for (ZoneStats &stats : Stats) {
+            stats.Average = stats.Calls ? stats.Total / stats.Calls : 0.0;
+            stats.CallsPerSecond = stats.Calls / seconds;
+            stats.Total = 0.0;
+            stats.Calls = 0;
+        }
+        IntervalStart = now;
+    }
+}
+
+// Records a finished CPU zone. May be called from any thread.
+void Profiler::Record(const char *name, double start, double end) {
+    unsigned int thread = ThreadIndex();
+    std::lock_guard<std::mutex> guard(Lock);
+    AddEvent({name, start, end - start, thread});
+}
+
+// Starts timing GPU commands with a GL_TIME_ELAPSED query
+// Queries of this kind cannot nest, so a zone opened inside another one is not timed on its own
+void Profiler::BeginGpuZone(const char *name) {
+    if (GpuZoneDepth++ > 0 || !Active() || !GpuQueries[0][0]) {
+        return;
+    }
+    unsigned int slot = Frame % PROFILER_GPU_FRAMES;
+    if (GpuZoneCount[slot] == PROFILER_GPU_ZONES) {
+        return;
+    }
+    unsigned int index = GpuZoneCount[slot]++;
+    GpuZones[slot][index] = {name, Now(), 0.0, PROFILER_GPU_THREAD};
+    glBeginQuery(GL_TIME_ELAPSED, GpuQueries[slot][index]);
+    GpuZoneOpen = true;
+}
+
+void Profiler::EndGpuZone() {
+    if (--GpuZoneDepth > 0 || !GpuZoneOpen) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    GpuZoneOpen = false;
+}
+
+// Draws the average time of each zone over the last interval, CPU zones first
+void Profiler::DrawOverlay(TextRenderer &text) {
+    static std::vector<ZoneStats> stats; // kept between frames, so that copying the stats does not allocate
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        stats.assign(Stats.begin(), Stats.end());
+    }
+    float y = 25.0f;
+    char line[128];
+    for (bool gpu : {false, true}) {
+        text.RenderText(gpu ? "GPU" : "CPU", 5.0f, y, 0.3f, glm::vec3(1.0f, 1.0f, 0.0f));
+        y += 14.0f;
+        for (const ZoneStats &zone : stats) {
+            if (zone.Gpu == gpu) {
+                snprintf(line, sizeof(line), "%-20s %7.3f ms %5.0f/s", zone.Name, zone.Average / 1000.0, zone.CallsPerSecond);
+                text.RenderText(line, 5.0f, y, 0.3f);
+                y += 14.0f;
+            }
+        }
+    }
+}
+
+// Writes the trace if one was captured and releases the GPU queries. Called at program termination.
+void Profiler::CleanUp() {
+    if (!TracePath.empty()) {
+        WriteTrace();
+    }
+    if (GpuQueries[0][0]) {
+        glDeleteQueries(PROFILER_GPU_FRAMES * PROFILER_GPU_ZONES, &GpuQueries[0][0]);
+        GpuQueries[0][0] = 0;
+    }
+}
+
+// Zones are recorded only if someone looks at them
+void Profiler::UpdateRecording() {
+    Recording = Overlay || !TracePath.empty();
+}
+
+// Returns the index of the calling thread, registering the thread on its first call
+unsigned int Profiler::ThreadIndex() {
+    thread_local unsigned int index = [] {
+        std::lock_guard<std::mutex> guard(Lock);
+        ThreadNames.push_back("Thread " + std::to_string(ThreadNames.size()));
+        return (unsigned int)ThreadNames.size() - 1;
+    }();
+    return index;
+}
+
+// Adds a finished zone to the stats of the current interval and to the trace. The lock must be held.
+void Profiler::AddEvent(const ProfileEvent &event) {
+    AllocationPause pause; // growing the stats and the trace is the profiler's cost, not the frame's
+    bool gpu = event.Thread == PROFILER_GPU_THREAD;
+    ZoneStats *stats = nullptr;
+    for (ZoneStats &zone : Stats) {
+        if (zone.Gpu == gpu && strcmp(zone.Name, event.Name) == 0) {
+            stats = &zone;
+            break;
+        }
+    }
+    if (!stats) {
+        Stats.push_back({event.Name, gpu, 0.0, 0, 0.0, 0.0});
+        stats = &Stats.back();
+    }
+    stats->Total += event.Duration;
+    stats->Calls++;
+    if (!TracePath.empty() && Trace.size() < PROFILER_MAX_TRACE_EVENTS) {
+        Trace.push_back(event);
+        if (Trace.size() == PROFILER_MAX_TRACE_EVENTS) {
+            std::cout << "ERROR::PROFILER: Trace is full, later zones are dropped" << std::endl;
+        }
+    }
+}
+
+// Writes the trace in the Chrome trace-event format, which chrome://tracing and Perfetto can open
+bool Profiler::WriteTrace() {
+    std::lock_guard<std::mutex> guard(Lock);
+    std::ofstream file(TracePath);
+    if (!file) {
+        std::cout << "ERROR::PROFILER: Could not write trace " << TracePath << std::endl;
+        return false;
+    }
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (unsigned int i = 0; i < ThreadNames.size(); i++) {
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i << ",\"args\":{\"name\":\"" << ThreadNames[i] << "\"}},\n";
+    }
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << PROFILER_GPU_THREAD << ",\"args\":{\"name\":\"GPU\"}}";
+    for (const ProfileEvent &event : Trace) {
+        file << ",\n{\"name\":\"" << event.Name << "\",\"cat\":\"" << (event.Thread == PROFILER_GPU_THREAD ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.Thread << ",\"ts\":" << event.Start << ",\"dur\":" << event.Duration << "}";
+    }
+    file << "\n]}\n";
+    std::cout << "Trace with " << Trace.size() << " zones written to " << TracePath << std::endl;
+    return true;
+}
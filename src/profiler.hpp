@@ -0,0 +1,129 @@
+/*
+ profiler.hpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Declaration of the Profiler class
+ A singleton that times scoped zones on the CPU and the GPU, shows them in an overlay and exports them as a Chrome trace.
+ */
+
+#ifndef profiler_hpp
+#define profiler_hpp
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Builds without the profiler define PROFILER_ENABLED as 0, which removes all zones from the code
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+const unsigned int PROFILER_GPU_FRAMES = 4; // frames a GPU query may take before its result is read
+const unsigned int PROFILER_GPU_ZONES = 32; // GPU zones per frame, later zones are skipped
+const double PROFILER_OVERLAY_INTERVAL = 0.5; // seconds over which the overlay averages each zone
+const size_t PROFILER_MAX_TRACE_EVENTS = 1000000; // events kept for the trace, later events are dropped
+const unsigned int PROFILER_GPU_THREAD = 0xFFFF; // thread index under which GPU zones are recorded
+
+class TextRenderer;
+
+// A finished zone. GPU zones start when their query was issued, as GL_TIME_ELAPSED only measures durations.
+struct ProfileEvent {
+    const char *Name;
+    double Start; // microseconds since the profiler started
+    double Duration; // microseconds
+    unsigned int Thread; // index of the recording thread, or PROFILER_GPU_THREAD
+};
+
+// Time spent in a zone during the current overlay interval, and the averages of the last interval
+struct ZoneStats {
+    const char *Name;
+    bool Gpu;
+    double Total;
+    unsigned int Calls;
+    double Average; // microseconds per call
+    double CallsPerSecond;
+};
+
+class Profiler {
+public:
+    static bool Overlay; // the overlay is shown, only used by the thread owning the OpenGL context
+
+    static bool Active() { return Recording.load(std::memory_order_relaxed); }
+    static double Now();
+    static void ToggleOverlay();
+    static void SetThreadName(const char *name);
+    static void StartTrace(const std::string &path);
+    static void BeginFrame();
+    static void Record(const char *name, double start, double end);
+    static void BeginGpuZone(const char *name);
+    static void EndGpuZone();
+    static void DrawOverlay(TextRenderer &text);
+    static void CleanUp();
+
+private:
+    static std::atomic<bool> Recording; // zones are only recorded while the overlay is shown or a trace is captured
+    static std::mutex Lock; // guards the stats and the trace
+    static std::vector<ZoneStats> Stats;
+    static std::vector<ProfileEvent> Trace;
+    static std::vector<std::string> ThreadNames;
+    static std::string TracePath; // empty unless a trace is captured
+    static double IntervalStart;
+    static unsigned int Frame;
+    static unsigned int GpuQueries[PROFILER_GPU_FRAMES][PROFILER_GPU_ZONES];
+    static ProfileEvent GpuZones[PROFILER_GPU_FRAMES][PROFILER_GPU_ZONES]; // zones whose queries are in flight
+    static unsigned int GpuZoneCount[PROFILER_GPU_FRAMES];
+    static unsigned int GpuZoneDepth; // number of GPU zones entered and not yet left
+    static bool GpuZoneOpen; // GL_TIME_ELAPSED queries cannot nest, so only the outermost zone has a query
+
+    Profiler() {}
+    static void UpdateRecording();
+    static unsigned int ThreadIndex();
+    static void AddEvent(const ProfileEvent &event);
+    static bool WriteTrace();
+};
+
+// Times the enclosing scope on the CPU
+class ProfileZone {
+public:
+    ProfileZone(const char *name) : Name(name), Start(Profiler::Active() ? Profiler::Now() : -1.0) {}
+    ~ProfileZone() {
+        if (Start >= 0.0) {
+            Profiler::Record(Name, Start, Profiler::Now());
+        }
+    }
+
+private:
+    const char *Name;
+    double Start; // negative if the zone is not recorded
+};
+
+// Times the enclosing scope on the GPU
+class GpuProfileZone {
+public:
+    GpuProfileZone(const char *name) {
+        Profiler::BeginGpuZone(name);
+    }
+    ~GpuProfileZone() {
+        Profiler::EndGpuZone();
+    }
+};
+
+#if PROFILER_ENABLED
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_GPU_ZONE(name) GpuProfileZone PROFILE_CONCAT(gpuProfileZone, __LINE__)(name)
+#define PROFILE_GPU_BEGIN(name) Profiler::BeginGpuZone(name)
+#define PROFILE_GPU_END() Profiler::EndGpuZone()
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_GPU_ZONE(name) ((void)0)
+#define PROFILE_GPU_BEGIN(name) ((void)0)
+#define PROFILE_GPU_END() ((void)0)
+#endif
+
+#endif /* profiler_hpp */
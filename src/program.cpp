@@ -1,7 +1,7 @@
 /*
  program.cpp
  Breakout
- Last updated on October 5, 2020
+ Last updated on October 19, 2026
  
  This is the file containing the "main" function that gets directly executed when the project is run.
  It creates a Game instance and manages a GLFW window in which the game is displayed.
@@ -12,29 +12,62 @@
 #include <GLFW/GLFW3.H>
 
 #include <iostream>
+#include <string>
 
 #include "game.hpp"
 #include "resource_manager.hpp"
+#include "asset_archive.hpp"
+#include "frame_pacer.hpp"
+#include "gl_state.hpp"
+#include "profiler.hpp"
+#include "metrics.hpp"
+#include "benchmark.hpp"
+#include "alloc_tracker.hpp"
+#include "shader_cache.hpp"
 
 // Method declaration
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
+void window_refresh_callback(GLFWwindow *window);
+bool ParseArguments(int argc, const char *argv[]);
+bool RunBenchmark(GLFWwindow *window);
+bool OpenAssetArchive(const char *executablePath);
+std::string ExecutableDirectory(const char *executablePath);
 
 // Window settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
+// Asset settings
+const char *ARCHIVE_NAME = "assets.pak";
+const char *SHADER_CACHE_NAME = "shader_cache";
+std::string archivePath; // set by --assets, otherwise the archive is searched for in the working directory and next to the executable
+
+// Metrics settings
+std::string metricsPath; // set by --metrics-file
+int metricsPort = 0; // set by --metrics-port
+
 // Creation of game
 Game breakout(SCR_WIDTH, SCR_HEIGHT);
 
 int main(int argc, const char *argv[]) {
+    if (!ParseArguments(argc, argv) || !OpenAssetArchive(argv[0])) {
+        return -1;
+    }
+    ShaderCache::Directory = ExecutableDirectory(argv[0]) + SHADER_CACHE_NAME; // kept next to the executable like the archive, wherever the game is started from
+    // metrics are enabled before any other thread starts, as the flag is read without synchronization
+    if (!Metrics::Start(metricsPath, metricsPort)) {
+        return -1;
+    }
+    
     // GLFW window initialization
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, breakout.BenchmarkMode.Headless ? GL_FALSE : GL_TRUE);
     
     GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Breakout", NULL, NULL);
     if (window == NULL) {
@@ -45,6 +78,7 @@ int main(int argc, const char *argv[]) {
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetKeyCallback(window, key_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
     
     // GLAD initialization
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
@@ -52,59 +86,289 @@ int main(int argc, const char *argv[]) {
         return -1;
     }
     
+    Profiler::SetThreadName("Render");
+    
     // Global OpenGL state configuration
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::SetBlend(true);
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (GLAD_GL_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF); // lets the driver choose how many threads compile shaders
+    }
     
-    // Game initialization
+    // Game initialization. The framebuffer may be larger than the window on high-DPI screens.
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
+    breakout.Resize(framebufferWidth, framebufferHeight);
     breakout.Init();
+    RenderSettings &settings = breakout.Settings;
+    FramePacer pacer(settings.Present, settings.FrameRateLimit, settings.FrameStats);
+    pacer.Apply();
+    
+    // A benchmark runs in place of the main loop and closes the window when done
+    int exitCode = 0;
+    if (breakout.BenchmarkMode.Enabled && !RunBenchmark(window)) {
+        exitCode = -1;
+    }
     
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
     
-    // Main render loop
+    // Main render loop. The game is simulated on its own thread, started once loading has finished.
     while (!glfwWindowShouldClose(window)) {
-        // Timing
+        // In the menu and the win screen, the loop sleeps until input arrives or an animated effect needs a frame
+        double idleTimeout;
+        if (!breakout.FrameDue(idleTimeout)) {
+            glfwWaitEventsTimeout(idleTimeout);
+            pacer.Idle();
+            continue;
+        }
+        
+        // Timing. Under the frame limiter, input is sampled right after the wait to keep it fresh.
+        pacer.WaitForFrame();
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
         
         glfwPollEvents();
         
-        // Game data update
-        breakout.ProcessInput(deltaTime);
-        breakout.Update(deltaTime);
-        
         // Game rendering
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        breakout.Render();
+        breakout.Render(deltaTime);
         
         glfwSwapBuffers(window);
+        pacer.EndFrame(breakout.FrameInputTime);
+        Metrics::EndFrame();
     }
     
     // Clean-up
+    breakout.StopSimulation();
+    Profiler::CleanUp();
+    Metrics::Stop();
     ResourceManager::CleanUp();
+    AssetArchive::Close();
     glfwTerminate();
-    return 0;
+    return exitCode;
 }
 
 // Processes key presses. Automatically called upon any keyboard action
+// Key events are queued for the simulation thread, which applies them before its next step. A benchmark only listens to its autopilot.
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode) {
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
     }
-    if (key >= 0 && key < 1024) {
-        if (action == GLFW_PRESS) {
-            breakout.Keys[key] = true;
-        } else if (action == GLFW_RELEASE) {
-            breakout.Keys[key] = false;
-            breakout.KeysProcessed[key] = false;
-        }
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+        Profiler::ToggleOverlay();
+        breakout.RequestRedraw();
     }
+    if (!breakout.BenchmarkMode.Enabled) {
+        breakout.QueueKeyEvent(key, action);
+    }
+}
+
+// Redraws the window while the game is idle. Automatically called when the window's contents need to be redrawn
+void window_refresh_callback(GLFWwindow *window) {
+    breakout.RequestRedraw();
 }
 
 // Resizes the scene to match target width and height. Automatically called when window size is changed
+// The viewport is updated by the game at the start of its next frame
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
-    glViewport(0, 0, width, height);
+    if (width > 0 && height > 0) {
+        // a minimized window reports a size of zero
+        breakout.Resize(width, height);
+    }
+}
+
+// Plays the benchmark for its number of ticks, rendering a frame after every simulation step as fast as possible, and reports the times
+// Loading is not timed. Returns false if the report could not be written.
+bool RunBenchmark(GLFWwindow *window) {
+    while (breakout.State == GAME_LOADING && !glfwWindowShouldClose(window)) {
+        breakout.Render(0.0f);
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+    Benchmark benchmark(breakout.BenchmarkMode);
+    const float step = (float)(1.0 / SIMULATION_RATE);
+    AllocationTracker::Enabled = true;
+    for (unsigned int tick = 0; tick < benchmark.Settings.Ticks && !glfwWindowShouldClose(window); tick++) {
+        double frameStart = glfwGetTime();
+        unsigned long long allocations = AllocationTracker::ThreadCount();
+        breakout.StepBenchmark(tick);
+        double simulated = glfwGetTime();
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        breakout.Render(step);
+        allocations = AllocationTracker::ThreadCount() - allocations; // the game's own work, before the driver presents the frame
+        glFinish(); // the GPU's share of the frame counts as rendering, e.g. the rasterization of a software renderer
+        double rendered = glfwGetTime();
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+        Metrics::EndFrame();
+        benchmark.Record({simulated - frameStart, rendered - simulated, glfwGetTime() - frameStart, allocations});
+    }
+    glfwSetWindowShouldClose(window, true);
+    return benchmark.Report((const char*)glGetString(GL_RENDERER), breakout.BricksDestroyed);
+}
+
+// Reads the render settings from the command line. Returns false if the arguments are invalid.
+//   --scale <factor>      resolution of the scene relative to the window (default 1.0)
+//   --msaa <samples>      number of MSAA samples, 0 disables multi-sampling (default 4)
+//   --dynamic-res <fps>   lowers the resolution down to --min-scale to hold the given frame rate
+//   --min-scale <factor>  lower bound of the resolution under --dynamic-res (default 0.5)
+//   --assets <path>       asset archive to read from (default assets.pak)
+//   --loose-assets        reads assets from loose files instead of the archive, for development
+//   --asset-overrides     reads only the assets whose loose files changed after the archive was packed from those files
+//   --present <mode>      vsync, uncapped or limit (default vsync)
+//   --fps-limit <fps>     frame rate under --present limit (default 60)
+//   --late-latch          samples input again right before the paddle is drawn
+//   --frame-stats         prints frame-time, input latency and GL state statistics every few seconds
+//   --trace <path>        records all profiler zones and writes them to a Chrome trace file on exit
+//   --metrics-file <path> writes runtime counters in the Prometheus text format to a file every second
+//   --metrics-port <port> serves the same counters over HTTP on localhost
+//   --benchmark <level>   plays a level from levels/, or the generated level "stress", with an autopilot and reports frame times
+//   --seed <n>            seed of the benchmark's random numbers (default 1)
+//   --ticks <n>           simulation steps run by the benchmark (default 3600)
+//   --stress-scale <n>    size of the stress level, in multiples of a built-in level (default 4)
+//   --benchmark-output <path>  writes the benchmark report to a file instead of standard output
+//   --headless            renders to a hidden window
+//   --audio <backend>     device, null or wav, which records the mix instead of playing it (default device)
+//   --audio-file <path>   file recorded to under --audio wav (default breakout.wav)
+bool ParseArguments(int argc, const char *argv[]) {
+    RenderSettings &settings = breakout.Settings;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--loose-assets") {
+            AssetArchive::LooseFiles = true;
+            continue;
+        } else if (arg == "--asset-overrides") {
+            AssetArchive::Overrides = true;
+            continue;
+        } else if (arg == "--late-latch") {
+            settings.LateLatch = true;
+            continue;
+        } else if (arg == "--frame-stats") {
+            settings.FrameStats = true;
+            continue;
+        } else if (arg == "--headless") {
+            breakout.BenchmarkMode.Headless = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cout << "ERROR::ARGUMENTS: Missing value for " << arg << std::endl;
+            return false;
+        }
+        try {
+            if (arg == "--scale") {
+                settings.RenderScale = std::stof(argv[++i]);
+            } else if (arg == "--msaa") {
+                settings.Samples = std::stoi(argv[++i]);
+            } else if (arg == "--dynamic-res") {
+                settings.TargetFrameRate = std::stof(argv[++i]);
+            } else if (arg == "--min-scale") {
+                settings.MinRenderScale = std::stof(argv[++i]);
+            } else if (arg == "--present") {
+                std::string mode = argv[++i];
+                if (mode == "vsync") {
+                    settings.Present = PRESENT_VSYNC;
+                } else if (mode == "uncapped") {
+                    settings.Present = PRESENT_UNCAPPED;
+                } else if (mode == "limit") {
+                    settings.Present = PRESENT_LIMITED;
+                } else {
+                    std::cout << "ERROR::ARGUMENTS: Unknown present mode " << mode << std::endl;
+                    return false;
+                }
+            } else if (arg == "--fps-limit") {
+                settings.FrameRateLimit = std::stof(argv[++i]);
+            } else if (arg == "--assets") {
+                archivePath = argv[++i];
+            } else if (arg == "--trace") {
+                Profiler::StartTrace(argv[++i]);
+            } else if (arg == "--metrics-file") {
+                metricsPath = argv[++i];
+            } else if (arg == "--metrics-port") {
+                metricsPort = std::stoi(argv[++i]);
+            } else if (arg == "--benchmark") {
+                std::string level = argv[++i];
+                breakout.BenchmarkMode.Enabled = true;
+                breakout.BenchmarkMode.Level = level == "stress" ? BENCHMARK_STRESS_LEVEL : std::stoul(level);
+            } else if (arg == "--seed") {
+                breakout.BenchmarkMode.Seed = std::stoul(argv[++i]);
+            } else if (arg == "--ticks") {
+                breakout.BenchmarkMode.Ticks = std::stoul(argv[++i]);
+            } else if (arg == "--stress-scale") {
+                breakout.BenchmarkMode.StressScale = std::stoul(argv[++i]);
+            } else if (arg == "--benchmark-output") {
+                breakout.BenchmarkMode.OutputPath = argv[++i];
+            } else if (arg == "--audio") {
+                std::string backend = argv[++i];
+                if (backend == "device") {
+                    breakout.AudioMode.Backend = AUDIO_DEVICE;
+                } else if (backend == "null") {
+                    breakout.AudioMode.Backend = AUDIO_NULL;
+                } else if (backend == "wav") {
+                    breakout.AudioMode.Backend = AUDIO_WAV;
+                } else {
+                    std::cout << "ERROR::ARGUMENTS: Unknown audio backend " << backend << std::endl;
+                    return false;
+                }
+            } else if (arg == "--audio-file") {
+                breakout.AudioMode.FilePath = argv[++i];
+            } else {
+                std::cout << "ERROR::ARGUMENTS: Unknown option " << arg << std::endl;
+                return false;
+            }
+        } catch (std::logic_error &e) {
+            std::cout << "ERROR::ARGUMENTS: Invalid value for " << arg << std::endl;
+            return false;
+        }
+    }
+    BenchmarkSettings &benchmark = breakout.BenchmarkMode;
+    if (benchmark.Enabled && ((benchmark.Level != BENCHMARK_STRESS_LEVEL && benchmark.Level >= NUM_LEVELS) || benchmark.StressScale == 0)) {
+        std::cout << "ERROR::ARGUMENTS: --benchmark takes a level from 0 to " << NUM_LEVELS - 1 << " or stress, with a positive --stress-scale" << std::endl;
+        return false;
+    }
+    if (benchmark.Enabled) {
+        settings.Present = PRESENT_UNCAPPED; // frames are timed as fast as they can be rendered
+        if (breakout.AudioMode.Backend == AUDIO_DEVICE) {
+            breakout.AudioMode.Backend = AUDIO_NULL; // benchmarks run silently, unless recorded to a file
+        }
+    }
+    if (settings.FrameRateLimit <= 0.0f) {
+        std::cout << "ERROR::ARGUMENTS: --fps-limit must be positive" << std::endl;
+        return false;
+    }
+    if (settings.RenderScale <= 0.0f || (settings.TargetFrameRate > 0.0f && (settings.MinRenderScale <= 0.0f || settings.MinRenderScale > settings.RenderScale))) {
+        std::cout << "ERROR::ARGUMENTS: Render scales must be positive and --min-scale may not exceed --scale" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Opens the asset archive, so the game does not depend on the working directory. Returns false if an archive given by --assets cannot be opened.
+// Without an archive, assets are read from loose files in the working directory.
+bool OpenAssetArchive(const char *executablePath) {
+    if (AssetArchive::LooseFiles) {
+        return true;
+    }
+    if (!archivePath.empty()) {
+        if (!AssetArchive::Open(archivePath)) {
+            std::cout << "ERROR::ARCHIVE: Could not open " << archivePath << std::endl;
+            return false;
+        }
+        return true;
+    }
+    if (!AssetArchive::Open(ARCHIVE_NAME) && !AssetArchive::Open(ExecutableDirectory(executablePath) + ARCHIVE_NAME)) {
+        std::cout << "No asset archive found, reading loose asset files" << std::endl;
+    }
+    return true;
+}
+
+// Returns the directory of the executable with a trailing separator, or an empty string if it was started without a path
+std::string ExecutableDirectory(const char *executablePath) {
+    std::string executableDir = executablePath;
+    size_t separator = executableDir.find_last_of("/\\");
+    return separator == std::string::npos ? "" : executableDir.substr(0, separator + 1);
 }
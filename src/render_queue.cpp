@@ -0,0 +1,125 @@
+/*
+ render_queue.cpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Implementation of the RenderQueue class
+ Collects the draw calls of a render pass and submits them sorted by their render state.
+ */
+
+#include "render_queue.hpp"
+#include "gl_state.hpp"
+#include "profiler.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+#if PROFILER_ENABLED
+// Names of the layers' GPU zones in the profiler
+static const char *LAYER_NAMES[] = {"Scene layer", "Paddle", "Powerups", "Particles", "Ball", "Text"};
+#endif
+
+RenderQueue::RenderQueue(StreamBuffer &stream) : Submitted(0), Stream(&stream) {}
+
+// Records a draw call. Uniforms set afterwards belong to this draw until the next one is added.
+void RenderQueue::Add(RenderLayer layer, const Shader &shader, unsigned int texture, BlendMode blend, unsigned int vao, GLenum primitive, GLint first, GLsizei count, GLsizei instances) {
+    unsigned int uniformEnd = (unsigned int)Uniforms.size();
+    Commands.push_back({layer, shader.ID, texture, blend, vao, primitive, first, count, instances, uniformEnd, uniformEnd});
+}
+
+// Sets a uniform of the last recorded draw
+void RenderQueue::SetUniform(GLint location, const glm::vec3 &value) {
+    PushUniform(location, UNIFORM_VEC3, &value[0], 1, 3);
+}
+
+void RenderQueue::SetUniform(GLint location, const glm::mat4 &value) {
+    PushUniform(location, UNIFORM_MAT4, &value[0][0], 1, 16);
+}
+
+// Issues all recorded draws sorted by layer, shader, texture and blend mode, then empties the queue
+// Draws with equal state keep the order they were recorded in, so consecutive draws mostly share their state
+// Blended draws may overlap, so within their layer they are only ordered by when they were recorded
+// The stream buffer is unmapped first, so that the draws can read the vertices written for them
+void RenderQueue::Submit() {
+    PROFILE_ZONE("Submit");
+    Order.resize(Commands.size());
+    std::iota(Order.begin(), Order.end(), 0u);
+    std::sort(Order.begin(), Order.end(), [this](unsigned int a, unsigned int b) {
+        const RenderCommand &x = Commands[a];
+        const RenderCommand &y = Commands[b];
+        unsigned int xRecorded = x.Blend == BLEND_OPAQUE ? 0 : a;
+        unsigned int yRecorded = y.Blend == BLEND_OPAQUE ? 0 : b;
+        return std::tie(x.Layer, xRecorded, x.Shader, x.Texture, x.Blend, a) < std::tie(y.Layer, yRecorded, y.Shader, y.Texture, y.Blend, b);
+    });
+
+    // redundant changes between consecutive draws are skipped by the state cache
+    Stream->Unmap();
+    GLState::ActiveTexture(GL_TEXTURE0);
+#if PROFILER_ENABLED
+    int layer = -1; // layer whose GPU zone is open
+#endif
+    for (unsigned int index : Order) {
+        const RenderCommand &command = Commands[index];
+#if PROFILER_ENABLED
+        if (command.Layer != layer) {
+            if (layer >= 0) {
+                PROFILE_GPU_END();
+            }
+            layer = command.Layer;
+            PROFILE_GPU_BEGIN(LAYER_NAMES[layer]);
+        }
+#endif
+        GLState::UseProgram(command.Shader);
+        GLState::BindTexture(command.Texture);
+        ApplyBlend(command.Blend);
+        GLState::BindVertexArray(command.VAO);
+        for (unsigned int i = command.UniformBegin; i < command.UniformEnd; i++) {
+            const RenderUniform &uniform = Uniforms[i];
+            const float *values = &UniformData[uniform.Offset];
+            switch (uniform.Type) {
+                case UNIFORM_VEC3: glUniform3fv(uniform.Location, uniform.Count, values); break;
+                case UNIFORM_MAT4: glUniformMatrix4fv(uniform.Location, uniform.Count, GL_FALSE, values); break;
+            }
+        }
+        if (command.Instances == 1) {
+            glDrawArrays(command.Primitive, command.First, command.Count);
+        } else {
+            glDrawArraysInstanced(command.Primitive, command.First, command.Count, command.Instances);
+        }
+    }
+#if PROFILER_ENABLED
+    if (layer >= 0) {
+        PROFILE_GPU_END();
+    }
+#endif
+
+    // restores the global blend mode for code drawing outside of the queue
+    ApplyBlend(BLEND_ALPHA);
+    Submitted = (unsigned int)Commands.size();
+    METRIC_ADD(METRIC_DRAW_CALLS, Commands.size());
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, Uniforms.size());
+    Commands.clear();
+    Uniforms.clear();
+    UniformData.clear();
+}
+
+// Appends a uniform to the last recorded draw
+void RenderQueue::PushUniform(GLint location, UniformType type, const float *values, GLsizei count, unsigned int components) {
+    Uniforms.push_back({location, type, count, (unsigned int)UniformData.size()});
+    UniformData.insert(UniformData.end(), values, values + count * components);
+    Commands.back().UniformEnd = (unsigned int)Uniforms.size();
+}
+
+// Enables or disables blending and sets the blend function of a blended draw
+void RenderQueue::ApplyBlend(BlendMode blend) {
+    GLState::SetBlend(blend != BLEND_OPAQUE);
+    if (blend == BLEND_OPAQUE) {
+        return;
+    } else if (blend == BLEND_ADDITIVE) {
+        GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE);
+    } else {
+        GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+}
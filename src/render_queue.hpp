@@ -0,0 +1,86 @@
+/*
+ render_queue.hpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Declaration of the RenderQueue class
+ Collects the draw calls of a render pass and submits them sorted by their render state.
+ */
+
+#ifndef render_queue_hpp
+#define render_queue_hpp
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "shader.hpp"
+#include "stream_buffer.hpp"
+
+// Layers are drawn in order. Within a layer, opaque draws are grouped by shader, texture and blend mode, so they must not overlap.
+// Blended draws follow them in the order they were recorded.
+enum RenderLayer {
+    LAYER_SCENE, // cached background and bricks
+    LAYER_PADDLE,
+    LAYER_OBJECTS, // falling powerups
+    LAYER_PARTICLES, // particle trail of the ball
+    LAYER_BALL,
+    LAYER_HUD // text
+};
+
+enum BlendMode {
+    BLEND_OPAQUE, // blending disabled
+    BLEND_ALPHA, // the global blend mode
+    BLEND_ADDITIVE
+};
+
+enum UniformType {
+    UNIFORM_VEC3, UNIFORM_MAT4
+};
+
+// A uniform value set right before a draw. Its floats are stored in the queue's uniform data.
+struct RenderUniform {
+    GLint Location;
+    UniformType Type;
+    GLsizei Count; // number of array elements
+    unsigned int Offset; // first float in the uniform data
+};
+
+// A single draw call together with the state it needs
+struct RenderCommand {
+    RenderLayer Layer;
+    unsigned int Shader;
+    unsigned int Texture; // bound to texture unit 0
+    BlendMode Blend;
+    unsigned int VAO;
+    GLenum Primitive;
+    GLint First;
+    GLsizei Count;
+    GLsizei Instances;
+    unsigned int UniformBegin, UniformEnd; // range of the command's uniforms
+};
+
+class RenderQueue {
+public:
+    unsigned int Submitted; // commands issued by the last Submit
+
+    RenderQueue(StreamBuffer &stream);
+
+    void Add(RenderLayer layer, const Shader &shader, unsigned int texture, BlendMode blend, unsigned int vao, GLenum primitive, GLint first, GLsizei count, GLsizei instances = 1);
+    void SetUniform(GLint location, const glm::vec3 &value);
+    void SetUniform(GLint location, const glm::mat4 &value);
+    void Submit();
+
+private:
+    StreamBuffer *Stream; // holds the vertices written for this frame's draws
+    std::vector<RenderCommand> Commands;
+    std::vector<unsigned int> Order; // indices of the commands in submission order
+    std::vector<RenderUniform> Uniforms;
+    std::vector<float> UniformData;
+
+    void PushUniform(GLint location, UniformType type, const float *values, GLsizei count, unsigned int components);
+    void ApplyBlend(BlendMode blend);
+};
+
+#endif /* render_queue_hpp */
@@ -1,113 +1,300 @@
 /*
  resource_manager.cpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Implementation of the ResourceManager class
  A singleton resource manager that loads and stores shaders and textures.
  */
 
 #include "resource_manager.hpp"
+#include "gl_state.hpp"
+#include "shader_cache.hpp"
+#include "asset_archive.hpp"
 
+#include <algorithm>
 #include <iostream>
-#include <sstream>
-#include <fstream>
+#include <memory>
+#include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
 std::unordered_map<std::string, Shader> ResourceManager::Shaders;
 std::unordered_map<std::string, Texture2D> ResourceManager::Textures;
+std::vector<PendingShader> ResourceManager::PendingShaders;
+
+// Declaration of helper methods
+void InjectDefines(std::string &code, const std::string &defines);
+const char *FormatName(unsigned int internalFormat);
 
 ResourceManager::ResourceManager() {}
 
 // Loads and compiles a shader from source paths and assigns it a name, and returns it
-Shader ResourceManager::LoadShader(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, std::string name) {
-    Shaders[name] = LoadShaderFromFile(vShaderPath, fShaderPath, gShaderPath);
+// Preprocessor definitions (e.g. "#define CHAOS\n") may be given to compile a specialized variant of the shader
+Shader ResourceManager::LoadShader(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, std::string name, std::string defines) {
+    Shaders[name] = LoadShaderFromFile(vShaderPath, fShaderPath, gShaderPath, defines);
     return Shaders[name];
 }
 
+// Reads the sources of a shader on a worker thread, then submits it to the driver on the OpenGL thread
+// The shader is only stored under its name once FinishShaders has found it built
+void ResourceManager::LoadShaderAsync(AssetLoader &loader, const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, std::string name, std::string defines) {
+    std::string vPath = vShaderPath;
+    std::string fPath = fShaderPath;
+    std::string gPath = gShaderPath ? gShaderPath : "";
+    loader.Enqueue([vPath, fPath, gPath, name, defines]() -> UploadTask {
+        std::string vertexCode, fragmentCode, geometryCode;
+        ReadShaderSources(vPath.c_str(), fPath.c_str(), gPath.empty() ? nullptr : gPath.c_str(), defines, vertexCode, fragmentCode, geometryCode);
+        return [name, vertexCode, fragmentCode, geometryCode, gPath]() {
+            SubmitShader(name, vertexCode, fragmentCode, geometryCode, !gPath.empty());
+        };
+    });
+}
+
+// Stores the shaders loaded asynchronously that the driver has finished building, and caches their binaries
+// Never waits for the driver. Called once per frame while loading; returns true once no shader is pending.
+bool ResourceManager::FinishShaders() {
+    for (size_t i = 0; i < PendingShaders.size();) {
+        PendingShader &pending = PendingShaders[i];
+        if (!pending.Program.Ready()) {
+            i++;
+            continue;
+        }
+        pending.Program.Finish();
+        if (pending.Cacheable) {
+            ShaderCache::Store(pending.CacheKey, pending.Program);
+        }
+        Shaders[pending.Name] = pending.Program;
+        PendingShaders.erase(PendingShaders.begin() + i);
+    }
+    return PendingShaders.empty();
+}
+
 // Gets a shader by name
-Shader ResourceManager::GetShader(std::string name) {
+Shader ResourceManager::GetShader(const std::string &name) {
     return Shaders[name];
 }
 
+// Gets a shader by name, loading it first if it has not been loaded (e.g. asynchronously) before
+Shader ResourceManager::GetOrLoadShader(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, std::string name, std::string defines) {
+    auto found = Shaders.find(name);
+    if (found != Shaders.end()) {
+        return found->second;
+    }
+    return LoadShader(vShaderPath, fShaderPath, gShaderPath, name, defines);
+}
+
 // Loads a texture from a source path, assigns it a name, and returns it
 Texture2D ResourceManager::LoadTexture(const char *path, std::string name, bool flipUV) {
     Textures[name] = LoadTextureFromFile(path, flipUV);
     return Textures[name];
 }
 
+// Decodes a texture on a worker thread and uploads it on the OpenGL thread
+// A compressed version of the texture is uploaded as it is, skipping the decoding
+// The texture object is created and named right away, so copies taken before the upload finishes refer to the same texture
+void ResourceManager::LoadTextureAsync(AssetLoader &loader, const char *path, std::string name, bool flipUV) {
+    Textures[name] = Texture2D();
+    std::string imagePath = path;
+    loader.Enqueue([imagePath, name, flipUV]() -> UploadTask {
+        std::shared_ptr<CompressedTexture> compressed = std::make_shared<CompressedTexture>();
+        if (LoadCompressedTexture(imagePath.c_str(), flipUV, *compressed)) {
+            return [name, compressed]() {
+                Textures[name].GenerateCompressed(compressed->Container);
+            };
+        }
+        int width, height, nrChannels;
+        stbi_set_flip_vertically_on_load_thread(flipUV);
+        unsigned char *data = DecodeImage(imagePath.c_str(), width, height, nrChannels);
+        return [imagePath, name, data, width, height, nrChannels]() {
+            UploadTexture(Textures[name], imagePath.c_str(), data, width, height, nrChannels);
+        };
+    });
+}
+
 // Gets a texture by name
-Texture2D ResourceManager::GetTexture(std::string name) {
+Texture2D ResourceManager::GetTexture(const std::string &name) {
     return Textures[name];
 }
 
+// Prints the GPU memory taken by every texture and in total
+void ResourceManager::ReportTextureMemory() {
+    std::vector<std::string> names;
+    for (auto &i : Textures) {
+        names.push_back(i.first);
+    }
+    std::sort(names.begin(), names.end());
+    size_t total = 0;
+    for (const std::string &name : names) {
+        const Texture2D &texture = Textures[name];
+        std::cout << "Texture " << name << ": " << texture.Width << "x" << texture.Height << ", " << FormatName(texture.Internal_Format) << ", " << texture.Mip_Levels << (texture.Mip_Levels == 1 ? " level, " : " levels, ") << (texture.Memory_Size + 1023) / 1024 << " KiB" << std::endl;
+        total += texture.Memory_Size;
+    }
+    std::cout << "Texture memory: " << (total + 1023) / 1024 << " KiB" << std::endl;
+}
+
 // Releases all allocated space for resources. Called at program termination.
 void ResourceManager::CleanUp() {
     for (auto i : Shaders) {
-        glDeleteProgram(i.second.ID);
+        GLState::DeleteProgram(i.second.ID);
     }
     for (auto i : Textures) {
-        glDeleteTextures(1, &i.second.ID);
+        GLState::DeleteTexture(i.second.ID);
     }
+    for (PendingShader &pending : PendingShaders) {
+        pending.Program.Finish();
+        GLState::DeleteProgram(pending.Program.ID);
+    }
+    PendingShaders.clear();
 }
 
 // Helper method to load and compile a shader program given its source paths
 // Only called inside LoadShader
-Shader ResourceManager::LoadShaderFromFile(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath) {
-    // pipeline: filestream -> stringstream -> string -> c_str
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::string geometryCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-    std::ifstream gShaderFile;
-    vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    gShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    try {
-        vShaderFile.open(vShaderPath);
-        fShaderFile.open(fShaderPath);
-        std::stringstream vShaderStream, fShaderStream;
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        vShaderFile.close();
-        fShaderFile.close();
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-        // geometry shaders are reserved for future updates
+Shader ResourceManager::LoadShaderFromFile(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, std::string defines) {
+    std::string vertexCode, fragmentCode, geometryCode;
+    ReadShaderSources(vShaderPath, fShaderPath, gShaderPath, defines, vertexCode, fragmentCode, geometryCode);
+    return CompileShader(vertexCode, fragmentCode, geometryCode, gShaderPath != nullptr);
+}
+
+// Helper method to read the sources of a shader program and inject preprocessor definitions
+// Does not use OpenGL, so it may be called on any thread
+void ResourceManager::ReadShaderSources(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, const std::string &defines, std::string &vertexCode, std::string &fragmentCode, std::string &geometryCode) {
+    // sources are read from the asset archive without touching the file system
+    AssetBlob vShaderBlob, fShaderBlob, gShaderBlob;
+    bool success = AssetArchive::Load(vShaderPath, vShaderBlob) && AssetArchive::Load(fShaderPath, fShaderBlob);
+    // geometry shaders are reserved for future updates
+    if (gShaderPath) {
+        success = success && AssetArchive::Load(gShaderPath, gShaderBlob);
+    }
+    if (!success) {
+        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
+    }
+    vertexCode = vShaderBlob.String();
+    fragmentCode = fShaderBlob.String();
+    geometryCode = gShaderBlob.String();
+    if (!defines.empty()) {
+        InjectDefines(vertexCode, defines);
+        InjectDefines(fragmentCode, defines);
         if (gShaderPath) {
-            gShaderFile.open(gShaderPath);
-            std::stringstream gShaderStream;
-            gShaderStream << gShaderFile.rdbuf();
-            gShaderFile.close();
-            geometryCode = gShaderStream.str();
+            InjectDefines(geometryCode, defines);
         }
-    } catch (std::ifstream::failure &e) {
-        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
     }
-    const char *vShaderCode = vertexCode.c_str();
-    const char *fShaderCode = fragmentCode.c_str();
-    const char *gShaderCode = geometryCode.c_str();
-    
+}
+
+// Helper method to build a shader program from its sources
+// Linked programs are cached on disk, falling back to compiling from source whenever the cached binary is missing or rejected
+Shader ResourceManager::CompileShader(const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode, bool hasGeometry) {
     Shader shader;
-    shader.Compile(vShaderCode, fShaderCode, gShaderPath ? gShaderCode : nullptr);
+    bool cacheSupported = ShaderCache::Supported();
+    unsigned long long cacheKey = 0;
+    if (cacheSupported) {
+        cacheKey = ShaderCache::Key(vertexCode, fragmentCode, geometryCode);
+        if (ShaderCache::Load(cacheKey, shader)) {
+            return shader;
+        }
+    }
+    shader.Compile(vertexCode.c_str(), fragmentCode.c_str(), hasGeometry ? geometryCode.c_str() : nullptr);
+    if (cacheSupported) {
+        ShaderCache::Store(cacheKey, shader);
+    }
     return shader;
 }
 
+// Helper method to start building a shader program from its sources, without waiting for the driver
+// A program found in the shader cache is stored right away, anything else is left to FinishShaders
+void ResourceManager::SubmitShader(const std::string &name, const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode, bool hasGeometry) {
+    PendingShader pending = {name, Shader(), ShaderCache::Supported(), 0};
+    if (pending.Cacheable) {
+        pending.CacheKey = ShaderCache::Key(vertexCode, fragmentCode, geometryCode);
+        if (ShaderCache::Load(pending.CacheKey, pending.Program)) {
+            Shaders[name] = pending.Program;
+            return;
+        }
+    }
+    pending.Program.Submit(vertexCode.c_str(), fragmentCode.c_str(), hasGeometry ? geometryCode.c_str() : nullptr);
+    PendingShaders.push_back(pending);
+}
+
 // Helper method to load a texture given its source path
 // Only called inside LoadTexture
 Texture2D ResourceManager::LoadTextureFromFile(const char *path, bool flipUV) {
     Texture2D texture;
+    CompressedTexture compressed;
+    if (LoadCompressedTexture(path, flipUV, compressed)) {
+        texture.GenerateCompressed(compressed.Container);
+        return texture;
+    }
     int width, height, nrChannels;
     stbi_set_flip_vertically_on_load(flipUV);
-    unsigned char *data = stbi_load(path, &width, &height, &nrChannels, 0);
+    unsigned char *data = DecodeImage(path, width, height, nrChannels);
+    UploadTexture(texture, path, data, width, height, nrChannels);
+    return texture;
+}
+
+// Helper method to read the compressed version of a texture, e.g. textures/ball.ctex for textures/ball.png
+// Returns false if there is none, or if it was flipped differently or uses a format the driver cannot sample
+// Does not use OpenGL, so it may be called on any thread
+bool ResourceManager::LoadCompressedTexture(const char *path, bool flipUV, CompressedTexture &compressed) {
+    std::string containerPath = TextureContainerPath(path);
+    if (!AssetArchive::Load(containerPath, compressed.Blob)) {
+        return false;
+    }
+    if (!ParseTextureContainer(compressed.Blob.Data, compressed.Blob.Size, compressed.Container)) {
+        std::cout << "ERROR::TEXTURE: " << containerPath << " is not a valid texture container" << std::endl;
+        return false;
+    }
+    return compressed.Container.Flipped == flipUV && Texture2D::FormatSupported(compressed.Container.Format);
+}
+
+// Helper method to decode an image stored in the asset archive. Returns nullptr on failure.
+// Does not use OpenGL, so it may be called on any thread
+unsigned char *ResourceManager::DecodeImage(const char *path, int &width, int &height, int &nrChannels) {
+    AssetBlob blob;
+    if (!AssetArchive::Load(path, blob)) {
+        return nullptr;
+    }
+    return stbi_load_from_memory(blob.Data, (int)blob.Size, &width, &height, &nrChannels, 0);
+}
+
+// Helper method to upload decoded image data to a texture and free the image data
+void ResourceManager::UploadTexture(Texture2D &texture, const char *path, unsigned char *data, int width, int height, int nrChannels) {
+    if (!data) {
+        std::cout << "ERROR::TEXTURE: Failed to load " << path << std::endl;
+        return;
+    }
     if (nrChannels == 4) {
         texture.Internal_Format = GL_RGBA;
         texture.Image_Format = GL_RGBA;
     }
     texture.Generate(width, height, data);
     stbi_image_free(data);
-    return texture;
+}
+
+// Inserts preprocessor definitions right after the #version directive of a shader source
+void InjectDefines(std::string &code, const std::string &defines) {
+    size_t version = code.find("#version");
+    if (version == std::string::npos) {
+        code.insert(0, defines);
+        return;
+    }
+    size_t lineEnd = code.find('\n', version);
+    if (lineEnd == std::string::npos) {
+        code += "\n" + defines;
+    } else {
+        code.insert(lineEnd + 1, defines);
+    }
+}
+
+// Names the internal format of a texture in the memory report
+const char *FormatName(unsigned int internalFormat) {
+    switch (internalFormat) {
+        case GL_RGB: return "RGB";
+        case GL_RGBA: return "RGBA";
+        case GL_RED: return "R";
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT: return "BC1";
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: return "BC3";
+        case GL_COMPRESSED_RGBA_BPTC_UNORM: return "BC7";
+        default: return "other";
+    }
 }
@@ -1,7 +1,7 @@
 /*
  resource_manager.hpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Declaration of the ResourceManager class
  A singleton resource manager that loads and stores shaders and textures.
@@ -14,25 +14,56 @@
 
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 #include "texture.hpp"
 #include "shader.hpp"
+#include "asset_loader.hpp"
+#include "asset_archive.hpp"
+#include "texture_container.hpp"
+
+// A program submitted to the driver whose result has not been queried yet
+struct PendingShader {
+    std::string Name;
+    Shader Program;
+    bool Cacheable;
+    unsigned long long CacheKey;
+};
+
+// A compressed texture read from its container, kept together with the bytes its levels point into
+struct CompressedTexture {
+    AssetBlob Blob;
+    TextureContainer Container;
+};
 
 class ResourceManager {
 public:
     static std::unordered_map<std::string, Shader> Shaders; // A map of all shader objects used in the game, distinguished by names
     static std::unordered_map<std::string, Texture2D> Textures; // A map of all texture objects used in the game, distinguished by names
     
-    static Shader LoadShader(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, std::string name);
-    static Shader GetShader(std::string name);
+    static Shader LoadShader(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, std::string name, std::string defines = "");
+    static void LoadShaderAsync(AssetLoader &loader, const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, std::string name, std::string defines = "");
+    static bool FinishShaders();
+    static Shader GetShader(const std::string &name);
+    static Shader GetOrLoadShader(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, std::string name, std::string defines = "");
     static Texture2D LoadTexture(const char *path, std::string name, bool flipUV);
-    static Texture2D GetTexture(std::string name);
+    static void LoadTextureAsync(AssetLoader &loader, const char *path, std::string name, bool flipUV);
+    static Texture2D GetTexture(const std::string &name);
+    static void ReportTextureMemory();
     static void CleanUp();
     
 private:
+    static std::vector<PendingShader> PendingShaders; // programs loaded asynchronously that are still being built by the driver
+    
     ResourceManager();
-    static Shader LoadShaderFromFile(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath = nullptr);
+    static Shader LoadShaderFromFile(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath = nullptr, std::string defines = "");
+    static void ReadShaderSources(const char *vShaderPath, const char *fShaderPath, const char *gShaderPath, const std::string &defines, std::string &vertexCode, std::string &fragmentCode, std::string &geometryCode);
+    static Shader CompileShader(const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode, bool hasGeometry);
+    static void SubmitShader(const std::string &name, const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode, bool hasGeometry);
     static Texture2D LoadTextureFromFile(const char *path, bool flipUV);
+    static bool LoadCompressedTexture(const char *path, bool flipUV, CompressedTexture &compressed);
+    static unsigned char *DecodeImage(const char *path, int &width, int &height, int &nrChannels);
+    static void UploadTexture(Texture2D &texture, const char *path, unsigned char *data, int width, int height, int nrChannels);
 };
 
 #endif /* resource_manager_hpp */
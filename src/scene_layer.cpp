@@ -0,0 +1,102 @@
+/*
+ scene_layer.cpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Implementation of the SceneLayer class
+ A singleton class that caches the static part of the scene (background and bricks) in an offscreen texture.
+ */
+
+#include "scene_layer.hpp"
+#include "gl_state.hpp"
+#include "profiler.hpp"
+
+#include <cmath>
+#include <iostream>
+
+// The layer is rendered at the resolution of the post processor so that compositing it does not lose detail
+SceneLayer::SceneLayer(unsigned int width, unsigned int height, unsigned int sceneWidth, unsigned int sceneHeight) : Layer(), Width(width), Height(height), SceneWidth(sceneWidth), SceneHeight(sceneHeight), Dirty(true) {
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    Layer.Wrap_S = GL_CLAMP_TO_EDGE;
+    Layer.Wrap_T = GL_CLAMP_TO_EDGE;
+    Layer.Generate(Width, Height, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Layer.ID, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "ERROR::SCENELAYER: Failed to initialize FBO" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+SceneLayer::~SceneLayer() {
+    glDeleteFramebuffers(1, &FBO);
+    GLState::DeleteTexture(Layer.ID);
+}
+
+// Reallocates the layer to match the resolution of the post processor
+void SceneLayer::Resize(unsigned int width, unsigned int height) {
+    Width = width;
+    Height = height;
+    Layer.Generate(Width, Height, NULL);
+    Invalidate();
+}
+
+// Marks the whole layer for redrawing. Called when a level is reset or switched.
+void SceneLayer::Invalidate() {
+    Dirty = true;
+    DirtyRegions.clear();
+}
+
+// Marks a region of the scene, usually a destroyed brick, for redrawing
+void SceneLayer::InvalidateRegion(glm::vec2 position, glm::vec2 size) {
+    if (!Dirty) {
+        DirtyRegions.push_back(glm::vec4(position.x, position.y, position.x + size.x, position.y + size.y));
+    }
+}
+
+// Redraws invalidated parts of the layer. Called each frame before the scene is rendered.
+void SceneLayer::Update(SpriteRenderer &renderer, Shader &brickShader, Texture2D &background, GameLevel &level) {
+    if (!Dirty && DirtyRegions.empty()) {
+        return;
+    }
+    PROFILE_ZONE("Scene layer update");
+    PROFILE_GPU_ZONE("Scene layer update");
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glViewport(0, 0, Width, Height);
+    if (Dirty) {
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        renderer.DrawSprite(background, glm::vec2(0.0f), glm::vec2(SceneWidth, SceneHeight));
+        level.Draw(brickShader);
+    } else {
+        // only the invalidated regions are redrawn. The scissor box is widened by one pixel to cover filtered brick edges.
+        // the level is drawn in a single instanced call, the scissor test discards everything outside the region
+        float scaleX = (float)Width / SceneWidth;
+        float scaleY = (float)Height / SceneHeight;
+        glEnable(GL_SCISSOR_TEST);
+        for (glm::vec4 &region : DirtyRegions) {
+            int x0 = (int)std::floor(region.x * scaleX) - 1;
+            int x1 = (int)std::ceil(region.z * scaleX) + 1;
+            int y0 = (int)std::floor(region.y * scaleY) - 1;
+            int y1 = (int)std::ceil(region.w * scaleY) + 1;
+            glScissor(x0, Height - y1, x1 - x0, y1 - y0); // scissor boxes use a bottom-left origin
+            glClear(GL_COLOR_BUFFER_BIT);
+            renderer.DrawSprite(background, glm::vec2(0.0f), glm::vec2(SceneWidth, SceneHeight));
+            level.Draw(brickShader);
+        }
+        glDisable(GL_SCISSOR_TEST);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    Dirty = false;
+    DirtyRegions.clear();
+}
+
+// Records the compositing of the cached layer into the scene pass
+void SceneLayer::Draw(SpriteRenderer &renderer, RenderQueue &queue) {
+    // the layer is opaque, so blending is skipped. A negative height flips the texture, whose origin is at the bottom-left.
+    renderer.QueueSprite(queue, LAYER_SCENE, Layer, glm::vec2(0.0f, SceneHeight), glm::vec2(SceneWidth, -(float)SceneHeight), 0.0f, glm::vec3(1.0f), BLEND_OPAQUE);
+}
@@ -0,0 +1,45 @@
+/*
+ scene_layer.hpp
+ Breakout
+ Last updated on October 19, 2026
+
+ Declaration of the SceneLayer class
+ A singleton class that caches the static part of the scene (background and bricks) in an offscreen texture.
+ */
+
+#ifndef scene_layer_hpp
+#define scene_layer_hpp
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "texture.hpp"
+#include "sprite_renderer.hpp"
+#include "game_level.hpp"
+
+class SceneLayer {
+public:
+    Texture2D Layer; // the cached background and bricks stored in a texture
+    unsigned int Width; // size of the layer in pixels
+    unsigned int Height;
+
+    SceneLayer(unsigned int width, unsigned int height, unsigned int sceneWidth, unsigned int sceneHeight);
+    ~SceneLayer();
+
+    void Resize(unsigned int width, unsigned int height);
+    void Invalidate();
+    void InvalidateRegion(glm::vec2 position, glm::vec2 size);
+    void Update(SpriteRenderer &renderer, Shader &brickShader, Texture2D &background, GameLevel &level);
+    void Draw(SpriteRenderer &renderer, RenderQueue &queue);
+
+private:
+    unsigned int FBO;
+    unsigned int SceneWidth; // size of the scene in game coordinates
+    unsigned int SceneHeight;
+    bool Dirty; // the whole layer has to be redrawn
+    std::vector<glm::vec4> DirtyRegions; // regions (min x, min y, max x, max y) in game coordinates to be redrawn
+};
+
+#endif /* scene_layer_hpp */
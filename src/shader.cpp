@@ -1,135 +1,168 @@
 /*
  shader.cpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Implementation of the Shader class
  The Shader class encapsulates built-in shader methods and provides utility functions to compile, use and manipulate shaders.
  */
 
 #include "shader.hpp"
+#include "gl_state.hpp"
+#include "metrics.hpp"
 
 #include <iostream>
 
-Shader::Shader() {}
+Shader::Shader() : ID(0), Stages() {}
 
-// Compiles and links a shader program given source codes stored as C-type strings
+// Compiles and links a shader program given source codes stored as C-type strings, and waits for the result
 void Shader::Compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource) {
-    unsigned int vertex, fragment, geometry;
-    
-    // compile vertex shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vertexSource, NULL);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
-    
-    // compile fragment shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fragmentSource, NULL);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
-    
-    // compile geometry shader if provided. Geometry shaders are currently not used in the game but this functionality is reserved for future updates.
-    if (geometrySource) {
-        geometry = glCreateShader(GL_GEOMETRY_SHADER);
-        glShaderSource(geometry, 1, &geometrySource, NULL);
-        glCompileShader(geometry);
-        checkCompileErrors(geometry, "GEOMETRY");
-    }
+    Submit(vertexSource, fragmentSource, geometrySource);
+    Finish();
+}
+
+// Starts compiling and linking a shader program without waiting for the result
+// With KHR_parallel_shader_compile the driver builds submitted programs concurrently until Ready or Finish query them
+void Shader::Submit(const char *vertexSource, const char *fragmentSource, const char *geometrySource) {
+    // vertex shader, fragment shader and, if provided, geometry shader
+    // geometry shaders are currently not used in the game but this functionality is reserved for future updates
+    const GLenum types[3] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER};
+    const char *sources[3] = {vertexSource, fragmentSource, geometrySource};
     
-    // link shader program
+    // link shader program. The binary is kept retrievable so that it can be stored in the shader cache.
     ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    if (geometrySource) {
-        glAttachShader(ID, geometry);
+    if (GLAD_GL_ARB_get_program_binary) {
+        glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    for (unsigned int i = 0; i < 3; i++) {
+        Stages[i] = 0;
+        if (sources[i]) {
+            Stages[i] = glCreateShader(types[i]);
+            glShaderSource(Stages[i], 1, &sources[i], NULL);
+            glCompileShader(Stages[i]);
+            glAttachShader(ID, Stages[i]);
+        }
     }
     glLinkProgram(ID);
+}
+
+// Returns whether a submitted program has finished linking, so that Finish does not block
+// Always true without KHR_parallel_shader_compile, where the driver builds programs when they are queried
+bool Shader::Ready() const {
+    if (!GLAD_GL_KHR_parallel_shader_compile) {
+        return true;
+    }
+    GLint done = GL_FALSE;
+    glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+}
+
+// Waits for a submitted program, reports its errors and deletes its shader objects
+void Shader::Finish() {
+    const char *names[3] = {"VERTEX", "FRAGMENT", "GEOMETRY"};
+    for (unsigned int i = 0; i < 3; i++) {
+        if (Stages[i]) {
+            checkCompileErrors(Stages[i], names[i]);
+        }
+    }
     checkCompileErrors(ID, "PROGRAM");
     
     // clean up
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-    if (geometrySource) {
-        glDeleteShader(geometry);
+    for (unsigned int &stage : Stages) {
+        if (stage) {
+            glDeleteShader(stage);
+            stage = 0;
+        }
     }
 }
 
 // Set shader as active
 void Shader::Use() const {
-    glUseProgram(ID);
+    GLState::UseProgram(ID);
 }
 
 // Assign value to a named uniform variable op type bool
-void Shader::setBool(const std::string &name, bool value) const {
+void Shader::setBool(const char *name, bool value) const {
     this->Use();
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int) value);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniform1i(glGetUniformLocation(ID, name), (int) value);
 }
 
 // Assign value to a named uniform variable of type int
-void Shader::setInt(const std::string &name, int value) const {
+void Shader::setInt(const char *name, int value) const {
     this->Use();
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniform1i(glGetUniformLocation(ID, name), value);
 }
 
 // Assign value to a named uniform variable of type float
-void Shader::setFloat(const std::string &name, float value) const {
+void Shader::setFloat(const char *name, float value) const {
     this->Use();
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniform1f(glGetUniformLocation(ID, name), value);
 }
 
 // Assign value to a named uniform variable of type vec2 by passing in a glm::vec2
-void Shader::setVec2(const std::string &name, const glm::vec2 &value) const {
+void Shader::setVec2(const char *name, const glm::vec2 &value) const {
     this->Use();
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniform2fv(glGetUniformLocation(ID, name), 1, &value[0]);
 }
 
 // Assign value to a named uniform variable of type vec2 by passing in 2 floats
-void Shader::setVec2(const std::string &name, float x, float y) const {
+void Shader::setVec2(const char *name, float x, float y) const {
     this->Use();
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniform2f(glGetUniformLocation(ID, name), x, y);
 }
 
 // Assign value to a named uniform variable of type vec3 by passing in a glm::vec3
-void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
+void Shader::setVec3(const char *name, const glm::vec3 &value) const {
     this->Use();
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniform3fv(glGetUniformLocation(ID, name), 1, &value[0]);
 }
 
 // Assign value to a named uniform variable of type vec3 by passing in 3 floats
-void Shader::setVec3(const std::string &name, float x, float y, float z) const {
+void Shader::setVec3(const char *name, float x, float y, float z) const {
     this->Use();
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniform3f(glGetUniformLocation(ID, name), x, y, z);
 }
 
 // Assign value to a named uniform variable of type vec4 by passing in a glm::vec4
-void Shader::setVec4(const std::string &name, const glm::vec4 &value) const {
+void Shader::setVec4(const char *name, const glm::vec4 &value) const {
     this->Use();
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniform4fv(glGetUniformLocation(ID, name), 1, &value[0]);
 }
 
 // Assign value to a named uniform variable of type vec4 by passing in 4 floats
-void Shader::setVec4(const std::string &name, float x, float y, float z, float w) const {
+void Shader::setVec4(const char *name, float x, float y, float z, float w) const {
     this->Use();
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniform4f(glGetUniformLocation(ID, name), x, y, z, w);
 }
 
 // Assign value to a named uniform variable of type mat2 (2x2 matrix) by passing in a glm::mat2
-void Shader::setMat2(const std::string &name, const glm::mat2 &mat) const {
+void Shader::setMat2(const char *name, const glm::mat2 &mat) const {
     this->Use();
-    glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniformMatrix2fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
 }
 
 // Assign value to a named uniform variable of type mat3 (3x3 matrix) by passing in a glm::mat3
-void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const {
+void Shader::setMat3(const char *name, const glm::mat3 &mat) const {
     this->Use();
-    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniformMatrix3fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
 }
 
 // Assign value to a named uniform variable of type mat4 (4x4 matrix) by passing in a glm::mat4
-void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
+void Shader::setMat4(const char *name, const glm::mat4 &mat) const {
     this->Use();
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    METRIC_ADD(METRIC_UNIFORM_UPLOADS, 1);
+    glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
 }
 
 // Checks and reports shader compilation and linkage errors
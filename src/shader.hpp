@@ -1,7 +1,7 @@
 /*
  shader.hpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Declaration of the Shader class
  The Shader class encapsulates built-in shader methods and provides utility functions to compile, use and manipulate shaders.
@@ -25,22 +25,27 @@ public:
     Shader();
     
     void Compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr);
+    void Submit(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr);
+    bool Ready() const;
+    void Finish();
     void Use() const;
     
-    void setBool(const std::string &name, bool value) const;
-    void setInt(const std::string &name, int value) const;
-    void setFloat(const std::string &name, float value) const;
-    void setVec2(const std::string &name, const glm::vec2 &value) const;
-    void setVec2(const std::string &name, float x, float y) const;
-    void setVec3(const std::string &name, const glm::vec3 &value) const;
-    void setVec3(const std::string &name, float x, float t, float z) const;
-    void setVec4(const std::string &name, const glm::vec4 &value) const;
-    void setVec4(const std::string &name, float x, float y, float z, float w) const;
-    void setMat2(const std::string &name, const glm::mat2 &mat) const;
-    void setMat3(const std::string &name, const glm::mat3 &mat) const;
-    void setMat4(const std::string &name, const glm::mat4 &mat) const;
+    void setBool(const char *name, bool value) const;
+    void setInt(const char *name, int value) const;
+    void setFloat(const char *name, float value) const;
+    void setVec2(const char *name, const glm::vec2 &value) const;
+    void setVec2(const char *name, float x, float y) const;
+    void setVec3(const char *name, const glm::vec3 &value) const;
+    void setVec3(const char *name, float x, float t, float z) const;
+    void setVec4(const char *name, const glm::vec4 &value) const;
+    void setVec4(const char *name, float x, float y, float z, float w) const;
+    void setMat2(const char *name, const glm::mat2 &mat) const;
+    void setMat3(const char *name, const glm::mat3 &mat) const;
+    void setMat4(const char *name, const glm::mat4 &mat) const;
     
 private:
+    unsigned int Stages[3]; // shader objects of a submitted program, deleted by Finish
+    
     void checkCompileErrors(unsigned int shader, std::string type);
 };
 
@@ -0,0 +1,136 @@
+/*
+ shader_cache.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the ShaderCache class
+ A static on-disk cache of linked shader programs, keyed by their sources and the OpenGL driver.
+ */
+
+#include "shader_cache.hpp"
+#include "gl_state.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Header written in front of every cached program binary
+struct ProgramBinaryHeader {
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t Key;
+    uint32_t Format;
+    uint32_t Length;
+};
+
+std::string ShaderCache::Directory = "shader_cache";
+
+// Declaration of helper methods
+uint64_t HashFNV1a(const std::string &data, uint64_t hash);
+
+ShaderCache::ShaderCache() {}
+
+// Program binaries need ARB_get_program_binary and at least one binary format exposed by the driver
+bool ShaderCache::Supported() {
+    if (!GLAD_GL_ARB_get_program_binary) {
+        return false;
+    }
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    return numFormats > 0;
+}
+
+// Computes the cache key of a program from its sources and the vendor, renderer and version strings of the driver
+// A driver update therefore invalidates all cached binaries
+unsigned long long ShaderCache::Key(const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode) {
+    static std::string driver;
+    if (driver.empty()) {
+        driver = std::string((const char*)glGetString(GL_VENDOR)) + "\n" + (const char*)glGetString(GL_RENDERER) + "\n" + (const char*)glGetString(GL_VERSION);
+    }
+    uint64_t hash = 14695981039346656037ull;
+    hash = HashFNV1a(driver, hash);
+    hash = HashFNV1a(vertexCode, hash);
+    hash = HashFNV1a(fragmentCode, hash);
+    hash = HashFNV1a(geometryCode, hash);
+    return hash;
+}
+
+// Creates a program from a cached binary. Returns false if there is no valid binary for the key,
+// in which case the shader has to be compiled from source.
+bool ShaderCache::Load(unsigned long long key, Shader &shader) {
+    std::ifstream file(PathOf(key), std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    ProgramBinaryHeader header;
+    if (!file.read((char*)&header, sizeof(header)) || header.Magic != SHADER_CACHE_MAGIC || header.Version != SHADER_CACHE_VERSION || header.Key != key) {
+        return false;
+    }
+    std::vector<char> binary(header.Length);
+    if (!file.read(binary.data(), header.Length)) {
+        return false;
+    }
+    
+    // the driver rejects binaries it cannot use, which is reported as a failed link
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.Format, binary.data(), header.Length);
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        GLState::DeleteProgram(program);
+        return false;
+    }
+    shader.ID = program;
+    return true;
+}
+
+// Writes the binary of a successfully linked program to the cache
+void ShaderCache::Store(unsigned long long key, const Shader &shader) {
+    GLint success, length;
+    glGetProgramiv(shader.ID, GL_LINK_STATUS, &success);
+    glGetProgramiv(shader.ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (!success || length <= 0) {
+        return;
+    }
+    std::vector<char> binary(length);
+    GLenum format;
+    glGetProgramBinary(shader.ID, length, nullptr, &format, binary.data());
+    
+    std::error_code error;
+    std::filesystem::create_directories(Directory, error);
+    // the binary is written to a temporary file first so that an interrupted write never leaves a corrupt entry behind
+    std::string path = PathOf(key);
+    std::string tempPath = path + ".tmp";
+    std::ofstream file(tempPath, std::ios::binary);
+    if (!file) {
+        std::cout << "WARNING::SHADER_CACHE: Could not write to " << Directory << std::endl;
+        return;
+    }
+    ProgramBinaryHeader header = {SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, key, format, (uint32_t)length};
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), length);
+    file.close();
+    std::filesystem::rename(tempPath, path, error);
+}
+
+// Returns the path of the cache entry of a key
+std::string ShaderCache::PathOf(unsigned long long key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", key);
+    return Directory + "/" + name;
+}
+
+// Continues a 64-bit FNV-1a hash with the bytes of a string
+uint64_t HashFNV1a(const std::string &data, uint64_t hash) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    // separates consecutive strings so that moving characters between them changes the hash
+    hash ^= 0xFF;
+    hash *= 1099511628211ull;
+    return hash;
+}
@@ -0,0 +1,36 @@
+/*
+ shader_cache.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the ShaderCache class
+ A static on-disk cache of linked shader programs, keyed by their sources and the OpenGL driver.
+ */
+
+#ifndef shader_cache_hpp
+#define shader_cache_hpp
+
+#include <glad/glad.h>
+
+#include <string>
+
+#include "shader.hpp"
+
+const unsigned int SHADER_CACHE_MAGIC = 0x43534B42; // "BKSC"
+const unsigned int SHADER_CACHE_VERSION = 1;
+
+class ShaderCache {
+public:
+    static std::string Directory; // directory in which program binaries are stored
+    
+    static bool Supported();
+    static unsigned long long Key(const std::string &vertexCode, const std::string &fragmentCode, const std::string &geometryCode);
+    static bool Load(unsigned long long key, Shader &shader);
+    static void Store(unsigned long long key, const Shader &shader);
+    
+private:
+    ShaderCache();
+    static std::string PathOf(unsigned long long key);
+};
+
+#endif /* shader_cache_hpp */
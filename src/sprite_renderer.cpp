@@ -1,42 +1,51 @@
 /*
  sprite_renderer.cpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Implementation of the SpriteRenderer class
  A singleton class to render 2D quads.
  */
 
 #include "sprite_renderer.hpp"
+#include "gl_state.hpp"
+#include "metrics.hpp"
+
+// Declaration of helper methods
+glm::mat4 SpriteModel(glm::vec2 position, glm::vec2 size, float rotation);
 
 SpriteRenderer::SpriteRenderer(Shader &shader) {
     this->shader = shader;
+    modelLocation = glGetUniformLocation(shader.ID, "model");
+    colorLocation = glGetUniformLocation(shader.ID, "spriteColor");
     initRenderData();
 }
 
 SpriteRenderer::~SpriteRenderer() {
-    glDeleteVertexArrays(1, &quadVAO);
+    GLState::DeleteVertexArray(quadVAO);
 }
 
 // Renders a 2D quad to current framebuffer
-void SpriteRenderer::DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size, float rotation, glm::vec3 color) {
+void SpriteRenderer::DrawSprite(const Texture2D &texture, glm::vec2 position, glm::vec2 size, float rotation, glm::vec3 color) {
     shader.Use();
     
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(position, 0.0f));
-    model = glm::translate(model, glm::vec3(0.5 * size.x, 0.5 * size.y, 0.0f));
-    model = glm::rotate(model, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
-    model = glm::translate(model, glm::vec3(-0.5 * size.x, -0.5 * size.y, 0.0f));
-    model = glm::scale(model, glm::vec3(size, 1.0f));
+    glm::mat4 model = SpriteModel(position, size, rotation);
     
     shader.setMat4("model", model);
     shader.setVec3("spriteColor", color);
     
-    glActiveTexture(GL_TEXTURE0);
+    GLState::ActiveTexture(GL_TEXTURE0);
     texture.Bind();
-    glBindVertexArray(quadVAO);
+    GLState::BindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);
+    METRIC_ADD(METRIC_DRAW_CALLS, 1);
+}
+
+// Records a 2D quad to be drawn when the queue is submitted
+void SpriteRenderer::QueueSprite(RenderQueue &queue, RenderLayer layer, const Texture2D &texture, glm::vec2 position, glm::vec2 size, float rotation, glm::vec3 color, BlendMode blend) {
+    queue.Add(layer, shader, texture.ID, blend, quadVAO, GL_TRIANGLE_STRIP, 0, 4);
+    queue.SetUniform(modelLocation, SpriteModel(position, size, rotation));
+    queue.SetUniform(colorLocation, color);
 }
 
 // Prepares VBO and VAO for rendering. Only has to be called once.
@@ -50,14 +59,25 @@ void SpriteRenderer::initRenderData() {
     
     unsigned int quadVBO;
     glGenVertexArrays(1, &quadVAO);
-    glBindVertexArray(quadVAO);
+    GLState::BindVertexArray(quadVAO);
     glGenBuffers(1, &quadVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
+}
+
+// Returns the model matrix of a quad rotated around its center
+glm::mat4 SpriteModel(glm::vec2 position, glm::vec2 size, float rotation) {
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, glm::vec3(position, 0.0f));
+    model = glm::translate(model, glm::vec3(0.5 * size.x, 0.5 * size.y, 0.0f));
+    model = glm::rotate(model, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+    model = glm::translate(model, glm::vec3(-0.5 * size.x, -0.5 * size.y, 0.0f));
+    model = glm::scale(model, glm::vec3(size, 1.0f));
+    return model;
 }
@@ -1,7 +1,7 @@
 /*
  sprite_renderer.hpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Declaration of the SpriteRenderer class
  A singleton class to render 2D quads.
@@ -16,17 +16,21 @@
 
 #include "shader.hpp"
 #include "texture.hpp"
+#include "render_queue.hpp"
 
 class SpriteRenderer {
 public:
     SpriteRenderer(Shader &shader);
     ~SpriteRenderer();
     
-    void DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size = glm::vec2(10.0f), float rotation = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+    void DrawSprite(const Texture2D &texture, glm::vec2 position, glm::vec2 size = glm::vec2(10.0f), float rotation = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+    void QueueSprite(RenderQueue &queue, RenderLayer layer, const Texture2D &texture, glm::vec2 position, glm::vec2 size = glm::vec2(10.0f), float rotation = 0.0f, glm::vec3 color = glm::vec3(1.0f), BlendMode blend = BLEND_ALPHA);
     
 private:
     Shader shader;
     unsigned int quadVAO;
+    GLint modelLocation;
+    GLint colorLocation;
     
     void initRenderData();
 };
@@ -0,0 +1,68 @@
+/*
+ spsc_queue.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration and implementation of the SPSCQueue class template
+ A fixed-capacity lock-free queue between one producer thread and one consumer thread.
+ */
+
+#ifndef spsc_queue_hpp
+#define spsc_queue_hpp
+
+#include <atomic>
+#include <cstddef>
+
+// Capacity must be a power of two
+template <typename T, size_t Capacity>
+class SPSCQueue {
+public:
+    SPSCQueue() : Head(0), Tail(0) {}
+    
+    // Called by the producer. Returns false without blocking if the queue is full.
+    bool Push(const T &item) {
+        size_t tail = Tail.load(std::memory_order_relaxed);
+        if (tail - Head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        Items[tail & (Capacity - 1)] = item;
+        Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Called by the consumer. Reads the next item without removing it, or returns false if the queue is empty.
+    bool Peek(T &item) const {
+        size_t head = Head.load(std::memory_order_relaxed);
+        if (head == Tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = Items[head & (Capacity - 1)];
+        return true;
+    }
+    
+    // Called by the consumer. Returns false without blocking if the queue is empty.
+    bool Pop(T &item) {
+        size_t head = Head.load(std::memory_order_relaxed);
+        if (head == Tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = Items[head & (Capacity - 1)];
+        Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Returns the number of queued items. Exact on neither side while the other side is running, but never more than Capacity.
+    size_t Size() const {
+        size_t head = Head.load(std::memory_order_acquire);
+        return Tail.load(std::memory_order_acquire) - head;
+    }
+    
+private:
+    static_assert((Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of two");
+    
+    T Items[Capacity];
+    alignas(64) std::atomic<size_t> Head; // next item to pop, written by the consumer
+    alignas(64) std::atomic<size_t> Tail; // next slot to push, written by the producer
+};
+
+#endif /* spsc_queue_hpp */
@@ -0,0 +1,124 @@
+/*
+ stream_buffer.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the StreamBuffer class
+ A singleton ring buffer from which all geometry rewritten every frame is sub-allocated.
+ */
+
+#include "stream_buffer.hpp"
+#include "gl_state.hpp"
+#include "metrics.hpp"
+
+#include <iostream>
+
+const GLuint64 STREAM_WAIT_TIMEOUT = 1000000; // nanoseconds per wait for a fence, repeated until it is signaled
+
+StreamBuffer::StreamBuffer(GLsizeiptr frameCapacity) : FrameCapacity(frameCapacity), Stalls(0), Frame(0), Cursor(0), MappedBegin(0), Mapped(nullptr), Fences() {
+    glGenBuffers(1, &ID);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, ID);
+    glBufferData(GL_ARRAY_BUFFER, FrameCapacity * STREAM_FRAMES, nullptr, GL_STREAM_DRAW);
+}
+
+StreamBuffer::~StreamBuffer() {
+    Unmap();
+    for (GLsync &fence : Fences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    for (unsigned int buffer : Retired) {
+        GLState::DeleteBuffer(buffer);
+    }
+    GLState::DeleteBuffer(ID);
+}
+
+// Moves on to the next region, waiting until the GPU has finished drawing from it
+// Buffers replaced by the last frame are deleted, which the driver defers until the GPU is done with them
+void StreamBuffer::BeginFrame() {
+    for (unsigned int buffer : Retired) {
+        GLState::DeleteBuffer(buffer);
+    }
+    Retired.clear();
+    Frame = (Frame + 1) % STREAM_FRAMES;
+    GLsync &fence = Fences[Frame];
+    if (fence) {
+        GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            Stalls++;
+            do {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_WAIT_TIMEOUT);
+            } while (status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    Cursor = Frame * FrameCapacity;
+}
+
+// Reserves space in the current frame's region and returns where to write it, or null if the buffer cannot be mapped
+// offset receives the position of the space in the buffer, which must be bound afterwards, as a full region moves the frame to a new buffer
+// The rest of the region is mapped on the first allocation after an unmap.
+void *StreamBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment, GLintptr &offset) {
+    GLintptr regionEnd = (Frame + 1) * FrameCapacity;
+    GLintptr begin = (Cursor + alignment - 1) / alignment * alignment;
+    if (begin + size > regionEnd) {
+        Grow(size);
+        regionEnd = FrameCapacity;
+        begin = 0;
+    }
+    if (!Mapped) {
+        // the GPU is done with this region and draws of the current frame only read below the cursor, so no synchronization is needed
+        GLState::BindBuffer(GL_ARRAY_BUFFER, ID);
+        Mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, Cursor, regionEnd - Cursor, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+        if (!Mapped) {
+            std::cout << "ERROR::STREAMBUFFER: Failed to map the buffer" << std::endl;
+            return nullptr;
+        }
+        MappedBegin = Cursor;
+    }
+    offset = begin;
+    Cursor = begin + size;
+    METRIC_ADD(METRIC_UPLOADED_BYTES, size);
+    return Mapped + (begin - MappedBegin);
+}
+
+// Makes the data written since the buffer was mapped visible to OpenGL. Must be called before drawing from the buffer.
+void StreamBuffer::Unmap() {
+    if (!Mapped) {
+        return;
+    }
+    GLState::BindBuffer(GL_ARRAY_BUFFER, ID);
+    glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, Cursor - MappedBegin);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    Mapped = nullptr;
+}
+
+// Moves the rest of the frame to a new buffer with at least twice the capacity per frame, large enough for an allocation of size bytes
+// The data written so far stays in the old buffer, which the frame's draws recorded so far keep reading until it is retired
+void StreamBuffer::Grow(GLsizeiptr size) {
+    Unmap();
+    Retired.push_back(ID);
+    for (GLsync &fence : Fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    do {
+        FrameCapacity *= 2;
+    } while (FrameCapacity < size);
+    glGenBuffers(1, &ID);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, ID);
+    glBufferData(GL_ARRAY_BUFFER, FrameCapacity * STREAM_FRAMES, nullptr, GL_STREAM_DRAW);
+    Frame = 0;
+    Cursor = 0;
+    METRIC_ADD(METRIC_STREAM_GROWTHS, 1);
+}
+
+// Fences the current frame's region once all of its draws have been issued
+void StreamBuffer::EndFrame() {
+    Unmap();
+    Fences[Frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
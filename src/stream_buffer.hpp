@@ -0,0 +1,49 @@
+/*
+ stream_buffer.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the StreamBuffer class
+ A singleton ring buffer from which all geometry rewritten every frame is sub-allocated.
+ */
+
+#ifndef stream_buffer_hpp
+#define stream_buffer_hpp
+
+#include <glad/glad.h>
+
+#include <vector>
+
+const GLsizeiptr STREAM_FRAME_CAPACITY = 256 * 1024; // initial bytes available to each frame
+const unsigned int STREAM_FRAMES = 3; // frames the GPU may lag behind before a frame's region is reused
+
+// The buffer is split into one region per frame in flight. Each frame writes its region through an unsynchronized mapping,
+// which never waits for the GPU. Instead, the region is fenced at the end of the frame and only reused once the fence is signaled.
+// Data must be written between BeginFrame and EndFrame, and the buffer unmapped before drawing from it.
+// A frame that runs out of space moves on to a new, larger buffer, so ID may change during a frame: users bind it after allocating.
+class StreamBuffer {
+public:
+    unsigned int ID;
+    GLsizeiptr FrameCapacity; // bytes available to each frame
+    unsigned long long Stalls; // frames that had to wait for the GPU to release their region
+    
+    StreamBuffer(GLsizeiptr frameCapacity = STREAM_FRAME_CAPACITY);
+    ~StreamBuffer();
+    
+    void BeginFrame();
+    void *Allocate(GLsizeiptr size, GLsizeiptr alignment, GLintptr &offset);
+    void Unmap();
+    void EndFrame();
+    
+private:
+    unsigned int Frame; // region written by the current frame
+    GLintptr Cursor; // next free byte of the region
+    GLintptr MappedBegin; // first byte of the mapped range
+    unsigned char *Mapped; // null while the buffer is not mapped
+    GLsync Fences[STREAM_FRAMES]; // signaled once the GPU has finished reading each region
+    std::vector<unsigned int> Retired; // buffers replaced during the current frame, still read by its draws
+    
+    void Grow(GLsizeiptr size);
+};
+
+#endif /* stream_buffer_hpp */
@@ -1,8 +1,8 @@
 /*
  text_renderer.cpp
  Breakout
- Last updated on October 1, 2020
- 
+ Last updated on October 19, 2026
+
  Implementation of the TextRenderer class
  A singleton class to render texts.
  */
@@ -10,102 +10,390 @@
 #include "text_renderer.hpp"
 
 #include "resource_manager.hpp"
+#include "gl_state.hpp"
+#include "metrics.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
-#include <freetype2/ft2build.h>
-#include FT_FREETYPE_H
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
+const float SDF_INF = 1e20f; // stands in for an infinite distance in the distance transform
+
+// Declaration of helper methods
+char32_t NextCodePoint(std::string_view text, size_t &i);
+std::vector<unsigned char> GenerateSDF(const unsigned char *bitmap, int width, int height, int pitch, int spread);
+bool RasterizeGlyph(FT_Face face, char32_t codePoint, GlyphBitmap &glyph);
+
 // Creates a TextRenderer object given screen dimensions
-TextRenderer::TextRenderer(unsigned int width, unsigned int height) {
-    TextShader = ResourceManager::LoadShader("shaders/text.vert", "shaders/text.frag", nullptr, "text");
+TextRenderer::TextRenderer(unsigned int width, unsigned int height, StreamBuffer &stream) : Stream(&stream), FT(nullptr), Face(nullptr), Atlas(0), AtlasHeight(0), PackCursor(0), ShelfHeight(0) {
+    TextShader = ResourceManager::GetOrLoadShader("shaders/text.vert", "shaders/text.frag", nullptr, "text");
     glm::mat4 projection = glm::ortho(0.0f, (float)width, (float)height, 0.0f, -1.0f, 1.0f);
     TextShader.setMat4("projection", projection);
     TextShader.setInt("text", 0);
+    TextColorLocation = glGetUniformLocation(TextShader.ID, "textColor");
     glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 4 * 4, nullptr, GL_DYNAMIC_DRAW);
+    GLState::BindVertexArray(VAO);
+    // the vertices are read from the stream buffer, where Flush writes them each frame and points the attributes at them
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
-// Loads a FreeType font from a given path and generates a character map
+TextRenderer::~TextRenderer() {
+    ReleaseFont();
+    GLState::DeleteVertexArray(VAO);
+}
+
+// Opens a FreeType font from a given path and prepares an empty glyph atlas
+// Glyphs are rasterized lazily the first time they are drawn
 void TextRenderer::Load(std::string fontPath, unsigned int fontSize) {
-    Characters.clear();
-    // initialize Freetype loader
+    ReleaseFont();
+    // initialize Freetype loader. The face is kept open for the lifetime of the renderer.
+    if (FT_Init_FreeType(&FT)) {
+        std::cout << "ERROR::FREETYPE: Could not initialize Freetype library" << std::endl;
+        FT = nullptr;
+        return;
+    }
+    // the face reads from FontData, which stays alive until the font is released
+    if (!AssetArchive::Load(fontPath, FontData) || FT_New_Memory_Face(FT, FontData.Data, (FT_Long)FontData.Size, 0, &Face)) {
+        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        Face = nullptr;
+        return;
+    }
+    FT_Set_Pixel_Sizes(Face, 0, fontSize);
+
+    // the atlas starts small and doubles in height whenever a new glyph does not fit
+    AtlasHeight = 256;
+    AtlasPixels.assign(GLYPH_ATLAS_WIDTH * AtlasHeight, 0);
+    PackCursor = glm::ivec2(0);
+    ShelfHeight = 0;
+    glGenTextures(1, &Atlas);
+    GLState::BindTexture(Atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // guards against alignment issues
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, GLYPH_ATLAS_WIDTH, AtlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, AtlasPixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GLState::BindTexture(0);
+}
+
+// Records a string of UTF-8 encoded text, which is drawn once Flush has passed it to a render queue
+// All glyphs are taken from the same atlas, so the whole string is drawn with a single draw call
+// Pre: Load has successfully returned
+void TextRenderer::RenderText(std::string_view text, float x, float y, float scale, glm::vec3 color) {
+    if (!Face) {
+        return;
+    }
+    // rasterize missing glyphs first, as this may grow the atlas
+    float baseline = GetCharacter('H').Bearing.y;
+    for (size_t i = 0; i < text.size();) {
+        GetCharacter(NextCodePoint(text, i));
+    }
+
+    // texture coordinates are kept in texels until Flush, as a later string may still grow the atlas
+    size_t first = Vertices.size();
+    for (size_t i = 0; i < text.size();) {
+        const Character &ch = GetCharacter(NextCodePoint(text, i));
+        if (ch.Size.x > 0 && ch.Size.y > 0) {
+            float xpos = x + ch.Bearing.x * scale;
+            float ypos = y + (baseline - ch.Bearing.y) * scale;
+            float w = ch.Size.x * scale;
+            float h = ch.Size.y * scale;
+            float u0 = (float)ch.AtlasPos.x;
+            float v0 = (float)ch.AtlasPos.y;
+            float u1 = (float)(ch.AtlasPos.x + ch.Size.x);
+            float v1 = (float)(ch.AtlasPos.y + ch.Size.y);
+            float quad[] = {
+                xpos, ypos, u0, v0,
+                xpos, ypos + h, u0, v1,
+                xpos + w, ypos, u1, v0,
+                xpos + w, ypos, u1, v0,
+                xpos, ypos + h, u0, v1,
+                xpos + w, ypos + h, u1, v1
+            };
+            Vertices.insert(Vertices.end(), quad, quad + 24);
+        }
+        x += (ch.Advance >> 6) * scale; // multiply by 64 as advance is in units of 1/64 pixels
+    }
+    if (Vertices.size() == first) {
+        return;
+    }
+
+    Runs.push_back({(GLint)(first / 4), (GLsizei)((Vertices.size() - first) / 4), color});
+}
+
+// Writes the vertices of all strings recorded since the last flush to the stream buffer and records their draws in a render queue
+void TextRenderer::Flush(RenderQueue &queue) {
+    const GLsizeiptr stride = 4 * sizeof(float);
+    GLintptr offset;
+    float *vertices = Vertices.empty() ? nullptr : (float*)Stream->Allocate(Vertices.size() * sizeof(float), stride, offset);
+    if (vertices) {
+        float atlasWidth = (float)GLYPH_ATLAS_WIDTH;
+        float atlasHeight = (float)AtlasHeight;
+        for (size_t i = 0; i < Vertices.size(); i += 4) {
+            vertices[i] = Vertices[i];
+            vertices[i + 1] = Vertices[i + 1];
+            vertices[i + 2] = Vertices[i + 2] / atlasWidth;
+            vertices[i + 3] = Vertices[i + 3] / atlasHeight;
+        }
+        // the attributes are pointed at the stream buffer on every flush, as it may have been replaced by a larger one
+        GLState::BindVertexArray(VAO);
+        GLState::BindBuffer(GL_ARRAY_BUFFER, Stream->ID);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(float)));
+        // the allocation is aligned to whole vertices, so draws can start at its first vertex
+        GLint base = (GLint)(offset / stride);
+        for (const TextRun &run : Runs) {
+            queue.Add(LAYER_HUD, TextShader, Atlas, BLEND_ALPHA, VAO, GL_TRIANGLES, base + run.First, run.Count);
+            queue.SetUniform(TextColorLocation, run.Color);
+        }
+    }
+    Vertices.clear();
+    Runs.clear();
+}
+
+// Inserts glyphs rasterized ahead of time, e.g. on a worker thread, into the atlas
+void TextRenderer::AddGlyphs(const std::vector<GlyphBitmap> &glyphs) {
+    for (const GlyphBitmap &glyph : glyphs) {
+        if (Characters.find(glyph.CodePoint) == Characters.end()) {
+            InsertGlyph(glyph);
+        }
+    }
+}
+
+// Rasterizes the distinct characters of a UTF-8 string with a private FreeType instance
+// Does not use OpenGL or the renderer's font, so it may be called on any thread
+std::vector<GlyphBitmap> TextRenderer::RasterizeGlyphs(std::string fontPath, unsigned int fontSize, std::string text) {
+    std::vector<GlyphBitmap> glyphs;
     FT_Library ft;
     if (FT_Init_FreeType(&ft)) {
         std::cout << "ERROR::FREETYPE: Could not initialize Freetype library" << std::endl;
+        return glyphs;
     }
+    AssetBlob fontData;
     FT_Face face;
-    if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
+    if (!AssetArchive::Load(fontPath, fontData) || FT_New_Memory_Face(ft, fontData.Data, (FT_Long)fontData.Size, 0, &face)) {
         std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        FT_Done_FreeType(ft);
+        return glyphs;
     }
     FT_Set_Pixel_Sizes(face, 0, fontSize);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // guards against alignment issues
-    // loops through all ASCII characters, generates a glyph for each
-    for (unsigned char c = 0; c < 128; c++) {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            std::cout << "ERROR::FREETYPE: Failed to load glyph " << (unsigned int)c << std::endl;
+    std::vector<char32_t> done;
+    for (size_t i = 0; i < text.size();) {
+        char32_t codePoint = NextCodePoint(text, i);
+        if (std::find(done.begin(), done.end(), codePoint) != done.end()) {
             continue;
         }
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            (unsigned int)face->glyph->advance.x
-        };
-        Characters.insert(std::pair<char, Character>(c, character));
-    }
-    // clean up
-    glBindTexture(GL_TEXTURE_2D, 0);
+        done.push_back(codePoint);
+        GlyphBitmap glyph;
+        if (RasterizeGlyph(face, codePoint, glyph)) {
+            glyphs.push_back(std::move(glyph));
+        }
+    }
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
+    return glyphs;
 }
 
-// Renders a string of text
-// Pre: Load has successfully returned
-void TextRenderer::RenderText(std::string text, float x, float y, float scale, glm::vec3 color) {
-    TextShader.Use();
-    TextShader.setVec3("textColor", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(VAO);
-    
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) {
-        Character ch = Characters[*c];
-        float xpos = x + ch.Bearing.x * scale;
-        float ypos = y + (Characters['H'].Bearing.y - ch.Bearing.y) * scale;
-        float w = ch.Size.x * scale;
-        float h = ch.Size.y * scale;
-        float vertices[] = {
-            xpos, ypos, 0.0f, 0.0f,
-            xpos, ypos + h, 0.0f, 1.0f,
-            xpos + w, ypos, 1.0f, 0.0f,
-            xpos + w, ypos + h, 1.0f, 1.0f
-        };
-        glBindTexture(GL_TEXTURE_2D, ch.Glyph);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        x += (ch.Advance >> 6) * scale; // multiply by 64 as advance is in units of 1/64 pixels
+// Returns the glyph of a code point, rasterizing it into the atlas as a signed distance field on first use
+const Character &TextRenderer::GetCharacter(char32_t codePoint) {
+    auto found = Characters.find(codePoint);
+    if (found != Characters.end()) {
+        return found->second;
+    }
+    GlyphBitmap glyph;
+    if (!RasterizeGlyph(Face, codePoint, glyph)) {
+        // failed glyphs are cached as empty characters so that loading is not retried every frame
+        std::cout << "ERROR::FREETYPE: Failed to load glyph " << (unsigned int)codePoint << std::endl;
+    }
+    return InsertGlyph(glyph);
+}
+
+// Packs a rasterized glyph into the atlas and registers it as a character
+const Character &TextRenderer::InsertGlyph(const GlyphBitmap &glyph) {
+    Character character = {glm::ivec2(0), glyph.Size, glyph.Bearing, glyph.Advance};
+    if (glyph.Size.x > 0 && glyph.Size.y > 0) {
+        character.AtlasPos = AllocateAtlasRegion(character.Size.x, character.Size.y);
+        for (int row = 0; row < character.Size.y; row++) {
+            std::copy(glyph.SDF.begin() + row * character.Size.x, glyph.SDF.begin() + (row + 1) * character.Size.x, AtlasPixels.begin() + (character.AtlasPos.y + row) * GLYPH_ATLAS_WIDTH + character.AtlasPos.x);
+        }
+        GLState::BindTexture(Atlas);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, character.AtlasPos.x, character.AtlasPos.y, character.Size.x, character.Size.y, GL_RED, GL_UNSIGNED_BYTE, glyph.SDF.data());
+        METRIC_ADD(METRIC_UPLOADED_BYTES, glyph.SDF.size());
+    }
+    return Characters[glyph.CodePoint] = character;
+}
+
+// Reserves a region of the atlas using a simple shelf packer and returns its top-left texel
+// The atlas texture is doubled in height and re-uploaded if the region does not fit
+glm::ivec2 TextRenderer::AllocateAtlasRegion(unsigned int width, unsigned int height) {
+    if (PackCursor.x + width > GLYPH_ATLAS_WIDTH) {
+        // start a new shelf below the current one, leaving a 1 texel gap to avoid bleeding
+        PackCursor = glm::ivec2(0, PackCursor.y + ShelfHeight + 1);
+        ShelfHeight = 0;
+    }
+    if (PackCursor.y + height > AtlasHeight) {
+        while (PackCursor.y + height > AtlasHeight) {
+            AtlasHeight *= 2;
+        }
+        AtlasPixels.resize(GLYPH_ATLAS_WIDTH * AtlasHeight, 0);
+        GLState::BindTexture(Atlas);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, GLYPH_ATLAS_WIDTH, AtlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, AtlasPixels.data());
+        METRIC_ADD(METRIC_UPLOADED_BYTES, AtlasPixels.size());
+    }
+    glm::ivec2 position = PackCursor;
+    PackCursor.x += width + 1;
+    ShelfHeight = std::max(ShelfHeight, height);
+    return position;
+}
+
+// Closes the current font and discards all cached glyphs
+void TextRenderer::ReleaseFont() {
+    Characters.clear();
+    if (Atlas) {
+        GLState::DeleteTexture(Atlas);
+        Atlas = 0;
+    }
+    if (Face) {
+        FT_Done_Face(Face);
+        Face = nullptr;
+    }
+    if (FT) {
+        FT_Done_FreeType(FT);
+        FT = nullptr;
+    }
+    FontData = AssetBlob();
+}
+
+// Loads a glyph with FreeType and converts it into a signed distance field. Returns false if the font cannot provide the glyph.
+// The quad of the glyph is padded on every side, as the distance field extends beyond the outline.
+bool RasterizeGlyph(FT_Face face, char32_t codePoint, GlyphBitmap &glyph) {
+    glyph.CodePoint = codePoint;
+    glyph.Size = glm::ivec2(0);
+    glyph.Bearing = glm::ivec2(0);
+    glyph.Advance = 0;
+    glyph.SDF.clear();
+    if (!face || FT_Load_Char(face, codePoint, FT_LOAD_RENDER)) {
+        return false;
+    }
+    FT_GlyphSlot slot = face->glyph;
+    glyph.Advance = (unsigned int)slot->advance.x;
+    int width = slot->bitmap.width;
+    int height = slot->bitmap.rows;
+    if (width > 0 && height > 0) {
+        int spread = GLYPH_SDF_SPREAD;
+        glyph.SDF = GenerateSDF(slot->bitmap.buffer, width, height, slot->bitmap.pitch, spread);
+        glyph.Size = glm::ivec2(width + 2 * spread, height + 2 * spread);
+        glyph.Bearing = glm::ivec2(slot->bitmap_left - spread, slot->bitmap_top + spread);
+    }
+    return true;
+}
+
+// Decodes the UTF-8 sequence starting at index i and advances i past it
+// Malformed sequences decode to the replacement character U+FFFD
+char32_t NextCodePoint(std::string_view text, size_t &i) {
+    unsigned char lead = text[i++];
+    if (lead < 0x80) {
+        return lead;
+    }
+    int length;
+    char32_t codePoint;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 1;
+        codePoint = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 2;
+        codePoint = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 3;
+        codePoint = lead & 0x07;
+    } else {
+        return 0xFFFD;
+    }
+    for (int k = 0; k < length; k++) {
+        if (i >= text.size() || ((unsigned char)text[i] & 0xC0) != 0x80) {
+            return 0xFFFD;
+        }
+        codePoint = (codePoint << 6) | ((unsigned char)text[i++] & 0x3F);
+    }
+    return codePoint;
+}
+
+// Computes the squared Euclidean distance transform of a sampled 1D function (Felzenszwalb & Huttenlocher)
+void DistanceTransform1D(const float *f, float *d, int *v, float *z, int n) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -SDF_INF;
+    z[1] = SDF_INF;
+    for (int q = 1; q < n; q++) {
+        float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = SDF_INF;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+// Replaces every cell of a 2D grid with its squared distance to the nearest zero cell
+void DistanceTransform2D(std::vector<float> &grid, int width, int height) {
+    int n = std::max(width, height);
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            f[y] = grid[y * width + x];
+        }
+        DistanceTransform1D(f.data(), d.data(), v.data(), z.data(), height);
+        for (int y = 0; y < height; y++) {
+            grid[y * width + x] = d[y];
+        }
+    }
+    for (int y = 0; y < height; y++) {
+        DistanceTransform1D(&grid[y * width], d.data(), v.data(), z.data(), width);
+        std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+    }
+}
+
+// Converts an 8-bit coverage bitmap into a signed distance field padded by spread texels on every side
+// A value of 128 lies on the outline; larger values are inside the glyph
+std::vector<unsigned char> GenerateSDF(const unsigned char *bitmap, int width, int height, int pitch, int spread) {
+    int sdfWidth = width + 2 * spread;
+    int sdfHeight = height + 2 * spread;
+    std::vector<float> toInside(sdfWidth * sdfHeight, SDF_INF);
+    std::vector<float> toOutside(sdfWidth * sdfHeight, 0.0f);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (bitmap[y * pitch + x] >= 128) {
+                int cell = (y + spread) * sdfWidth + x + spread;
+                toInside[cell] = 0.0f;
+                toOutside[cell] = SDF_INF;
+            }
+        }
+    }
+    DistanceTransform2D(toInside, sdfWidth, sdfHeight);
+    DistanceTransform2D(toOutside, sdfWidth, sdfHeight);
+
+    std::vector<unsigned char> sdf(sdfWidth * sdfHeight);
+    for (int i = 0; i < sdfWidth * sdfHeight; i++) {
+        float distance = std::sqrt(toOutside[i]) - std::sqrt(toInside[i]);
+        float value = 0.5f + distance / (2.0f * spread);
+        sdf[i] = (unsigned char)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f);
     }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    return sdf;
 }
@@ -1,8 +1,8 @@
 /*
  text_renderer.hpp
  Breakout
- Last updated on October 1, 2020
- 
+ Last updated on October 19, 2026
+
  Declaration of the TextRenderer class
  A singleton class to render texts.
  */
@@ -12,33 +12,79 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <freetype2/ft2build.h>
+#include FT_FREETYPE_H
 
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "texture.hpp"
 #include "shader.hpp"
+#include "asset_archive.hpp"
+#include "render_queue.hpp"
+#include "stream_buffer.hpp"
+
+const unsigned int GLYPH_ATLAS_WIDTH = 1024; // width of the glyph atlas in texels. The atlas grows vertically on demand.
+const unsigned int GLYPH_SDF_SPREAD = 8; // distance in texels covered by the signed distance field around each glyph outline
 
-// Definition of a Truetype character
+// Definition of a Truetype character stored in the glyph atlas
 struct Character {
-    unsigned int Glyph; // stored as texture
+    glm::ivec2 AtlasPos; // top-left texel of the glyph inside the atlas
+    glm::ivec2 Size; // size of the glyph quad including the SDF padding
+    glm::ivec2 Bearing; // offset from the pen position, adjusted for the SDF padding
+    unsigned int Advance;
+};
+
+// A glyph rasterized as a signed distance field on the CPU, ready to be inserted into the atlas
+struct GlyphBitmap {
+    char32_t CodePoint;
     glm::ivec2 Size;
     glm::ivec2 Bearing;
     unsigned int Advance;
+    std::vector<unsigned char> SDF; // Size.x * Size.y texels
+};
+
+// A string recorded since the last flush, drawn with one draw call
+struct TextRun {
+    GLint First; // first vertex of the string
+    GLsizei Count;
+    glm::vec3 Color;
 };
 
 class TextRenderer {
 public:
-    std::unordered_map<char, Character> Characters; // stores all ASCII characters
+    std::unordered_map<char32_t, Character> Characters; // glyphs rasterized so far, keyed by Unicode code point
     Shader TextShader;
-    
-    TextRenderer(unsigned int width, unsigned int height);
+
+    TextRenderer(unsigned int width, unsigned int height, StreamBuffer &stream);
+    ~TextRenderer();
     void Load(std::string fontPath, unsigned int fontSize);
-    void RenderText(std::string text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
-    
+    void RenderText(std::string_view text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
+    void Flush(RenderQueue &queue);
+    void AddGlyphs(const std::vector<GlyphBitmap> &glyphs);
+    static std::vector<GlyphBitmap> RasterizeGlyphs(std::string fontPath, unsigned int fontSize, std::string text);
+
 private:
     unsigned int VAO;
-    unsigned int VBO;
+    StreamBuffer *Stream; // holds the vertices of the strings drawn in the current frame
+    FT_Library FT;
+    FT_Face Face;
+    AssetBlob FontData; // font file backing Face
+    unsigned int Atlas; // single-channel SDF atlas shared by all glyphs
+    unsigned int AtlasHeight;
+    std::vector<unsigned char> AtlasPixels; // CPU copy of the atlas, used to re-upload when the atlas grows
+    glm::ivec2 PackCursor; // next free texel on the current shelf
+    unsigned int ShelfHeight; // height of the tallest glyph on the current shelf
+    std::vector<float> Vertices; // vertices of the strings recorded since the last flush, with texture coordinates in texels
+    std::vector<TextRun> Runs;
+    GLint TextColorLocation;
+
+    const Character &GetCharacter(char32_t codePoint);
+    const Character &InsertGlyph(const GlyphBitmap &glyph);
+    glm::ivec2 AllocateAtlasRegion(unsigned int width, unsigned int height);
+    void ReleaseFont();
 };
 
 #endif /* text_renderer_hpp */
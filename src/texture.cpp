@@ -1,30 +1,66 @@
 /*
  texture.cpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Implementation of the Texture2D class
  The Texture2D class encapsulates properties of OpenGL 2D textures. It facilitates creations and usages of textures in the game.
  */
 
 #include "texture.hpp"
+#include "gl_state.hpp"
 
-Texture2D::Texture2D() : Width(0), Height(0), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_S(GL_REPEAT), Wrap_T(GL_REPEAT), Mag_Filter(GL_LINEAR), Min_Filter(GL_LINEAR) {
+Texture2D::Texture2D() : Width(0), Height(0), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_S(GL_REPEAT), Wrap_T(GL_REPEAT), Mag_Filter(GL_LINEAR), Min_Filter(GL_LINEAR), Mip_Levels(1), Memory_Size(0) {
     glGenTextures(1, &ID);
 }
 
 void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char *data) {
     Width = width;
     Height = height;
-    glBindTexture(GL_TEXTURE_2D, ID);
+    Mip_Levels = 1;
+    Memory_Size = (size_t)width * height * (Internal_Format == GL_RGBA ? 4 : Internal_Format == GL_RED ? 1 : 3);
+    GLState::BindTexture(ID);
     glTexImage2D(GL_TEXTURE_2D, 0, Internal_Format, width, height, 0, Image_Format, GL_UNSIGNED_BYTE, data);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, Wrap_S);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, Wrap_T);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, Mag_Filter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, Min_Filter);
-    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Uploads a block-compressed texture with all mip levels of its container, without decoding it
+// Minification samples between mip levels when the container has more than one
+void Texture2D::GenerateCompressed(const TextureContainer &container) {
+    static const unsigned int glFormats[] = {0, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_COMPRESSED_RGBA_BPTC_UNORM};
+    Width = container.Width;
+    Height = container.Height;
+    Internal_Format = glFormats[container.Format];
+    Image_Format = container.Format == TEXTURE_BC1 ? GL_RGB : GL_RGBA;
+    Mip_Levels = (unsigned int)container.Levels.size();
+    Memory_Size = 0;
+    if (Mip_Levels > 1 && Min_Filter == GL_LINEAR) {
+        Min_Filter = GL_LINEAR_MIPMAP_LINEAR;
+    }
+    GLState::BindTexture(ID);
+    for (unsigned int i = 0; i < Mip_Levels; i++) {
+        const TextureLevel &level = container.Levels[i];
+        glCompressedTexImage2D(GL_TEXTURE_2D, i, Internal_Format, level.Width, level.Height, 0, (GLsizei)level.Size, level.Data);
+        Memory_Size += level.Size;
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, Mip_Levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, Wrap_S);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, Wrap_T);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, Mag_Filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, Min_Filter);
+}
+
+// Returns whether the driver can sample a compression format
+bool Texture2D::FormatSupported(TextureFormat format) {
+    if (format == TEXTURE_BC7) {
+        return GLAD_GL_ARB_texture_compression_bptc;
+    }
+    return GLAD_GL_EXT_texture_compression_s3tc;
 }
 
 void Texture2D::Bind() const {
-    glBindTexture(GL_TEXTURE_2D, ID);
+    GLState::BindTexture(ID);
 }
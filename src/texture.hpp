@@ -1,7 +1,7 @@
 /*
  texture.hpp
  Breakout
- Last updated on September 30, 2020
+ Last updated on October 19, 2026
  
  Declaration of the Texture2D class
  The Texture2D class encapsulates properties of OpenGL 2D textures. It facilitates creations and usages of textures in the game.
@@ -12,6 +12,10 @@
 
 #include <glad/glad.h>
 
+#include <cstddef>
+
+#include "texture_container.hpp"
+
 class Texture2D {
 public:
     unsigned int ID;
@@ -23,10 +27,14 @@ public:
     unsigned int Wrap_T;
     unsigned int Mag_Filter;
     unsigned int Min_Filter;
+    unsigned int Mip_Levels;
+    size_t Memory_Size; // bytes of GPU memory taken by all mip levels
     
     Texture2D();
     
     void Generate(unsigned int width, unsigned int height, unsigned char *data);
+    void GenerateCompressed(const TextureContainer &container);
+    static bool FormatSupported(TextureFormat format);
     void Bind() const;
 };
 
@@ -0,0 +1,76 @@
+/*
+ texture_container.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the compressed texture container
+ A block-compressed texture with its full mip chain, written offline by the compress_textures tool and uploaded without decoding.
+ */
+
+#include "texture_container.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Returns the number of bytes of a 4x4 block
+size_t TextureBlockSize(TextureFormat format) {
+    return format == TEXTURE_BC1 ? 8 : 16;
+}
+
+// Returns the number of bytes of a mip level. Partial blocks at the edges are stored in full.
+size_t TextureLevelSize(TextureFormat format, unsigned int width, unsigned int height) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * TextureBlockSize(format);
+}
+
+// Returns the length of a full mip chain, down to a single texel
+unsigned int TextureMipCount(unsigned int width, unsigned int height) {
+    unsigned int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1u, width / 2);
+        height = std::max(1u, height / 2);
+        levels++;
+    }
+    return levels;
+}
+
+// Returns the path of the compressed version of an image, e.g. textures/ball.ctex for textures/ball.png
+std::string TextureContainerPath(const std::string &imagePath) {
+    size_t dot = imagePath.find_last_of('.');
+    size_t slash = imagePath.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return imagePath + TEXTURE_CONTAINER_EXTENSION;
+    }
+    return imagePath.substr(0, dot) + TEXTURE_CONTAINER_EXTENSION;
+}
+
+// Reads the header of a container and locates its mip levels. Returns false if the container is invalid or truncated.
+bool ParseTextureContainer(const unsigned char *data, size_t size, TextureContainer &container) {
+    TextureContainerHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.Magic != TEXTURE_CONTAINER_MAGIC || header.Version != TEXTURE_CONTAINER_VERSION
+        || header.Format < TEXTURE_BC1 || header.Format > TEXTURE_BC7 || header.Width == 0 || header.Height == 0
+        || header.NumLevels == 0 || header.NumLevels > TextureMipCount(header.Width, header.Height)) {
+        return false;
+    }
+    container.Format = (TextureFormat)header.Format;
+    container.Width = header.Width;
+    container.Height = header.Height;
+    container.Flipped = header.Flipped != 0;
+    container.Levels.clear();
+    size_t offset = sizeof(header);
+    unsigned int width = header.Width, height = header.Height;
+    for (unsigned int i = 0; i < header.NumLevels; i++) {
+        size_t levelSize = TextureLevelSize(container.Format, width, height);
+        if (levelSize > size - offset) {
+            return false;
+        }
+        container.Levels.push_back({width, height, data + offset, levelSize});
+        offset += levelSize;
+        width = std::max(1u, width / 2);
+        height = std::max(1u, height / 2);
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+/*
+ texture_container.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the compressed texture container
+ A block-compressed texture with its full mip chain, written offline by the compress_textures tool and uploaded without decoding.
+ */
+
+#ifndef texture_container_hpp
+#define texture_container_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const uint32_t TEXTURE_CONTAINER_MAGIC = 0x58544B42; // "BKTX"
+const uint32_t TEXTURE_CONTAINER_VERSION = 1;
+const char *const TEXTURE_CONTAINER_EXTENSION = ".ctex";
+
+// Block compression formats. Every format encodes 4x4 texel blocks.
+enum TextureFormat {
+    TEXTURE_BC1 = 1, // S3TC DXT1, RGB at 8 bytes per block
+    TEXTURE_BC3 = 2, // S3TC DXT5, RGBA at 16 bytes per block
+    TEXTURE_BC7 = 3  // BPTC, RGBA at 16 bytes per block
+};
+
+// Layout of the container: a header, then the data of every mip level from the largest to the smallest
+struct TextureContainerHeader {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t Format;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t NumLevels;
+    uint32_t Flipped; // whether the rows were flipped vertically, like stbi_set_flip_vertically_on_load
+    uint32_t Reserved;
+};
+
+struct TextureLevel {
+    unsigned int Width;
+    unsigned int Height;
+    const unsigned char *Data;
+    size_t Size;
+};
+
+// A parsed container. The levels point into the bytes the container was parsed from.
+struct TextureContainer {
+    TextureFormat Format;
+    unsigned int Width;
+    unsigned int Height;
+    bool Flipped;
+    std::vector<TextureLevel> Levels;
+};
+
+size_t TextureBlockSize(TextureFormat format);
+size_t TextureLevelSize(TextureFormat format, unsigned int width, unsigned int height);
+unsigned int TextureMipCount(unsigned int width, unsigned int height);
+std::string TextureContainerPath(const std::string &imagePath);
+bool ParseTextureContainer(const unsigned char *data, size_t size, TextureContainer &container);
+
+#endif /* texture_container_hpp */
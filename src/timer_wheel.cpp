@@ -0,0 +1,131 @@
+/*
+ timer_wheel.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Implementation of the TimerWheel class
+ A hierarchical timer wheel on simulation steps, which expires timed effects without counting each of them down every step.
+ */
+
+#include "timer_wheel.hpp"
+
+const unsigned long long TIMER_HORIZON = 1ull << (TIMER_SLOT_BITS * TIMER_LEVELS); // timers further ahead are clamped to the last step before it
+
+TimerWheel::TimerWheel(unsigned int capacity) : Current(0), Count(0), FreeHead(TIMER_NONE), Timers(capacity), Buckets(EXPIRING_BUCKET + 1, TIMER_NONE) {
+    for (unsigned int index = capacity; index-- > 0;) {
+        Timers[index].Bucket = TIMER_NONE;
+        Timers[index].Generation = 1;
+        Timers[index].Next = FreeHead;
+        FreeHead = index;
+    }
+}
+
+// Schedules a timer that expires in the step delay steps after the current one. Returns an invalid handle if the wheel is full.
+TimerHandle TimerWheel::Schedule(unsigned long long delay, TimerEvent event) {
+    TimerHandle handle;
+    if (FreeHead == TIMER_NONE) {
+        return handle;
+    }
+    unsigned int index = FreeHead;
+    Timer &timer = Timers[index];
+    FreeHead = timer.Next;
+    timer.Due = Current + (delay < TIMER_HORIZON ? delay : TIMER_HORIZON - 1);
+    timer.Event = event;
+    Insert(index);
+    Count++;
+    handle.Index = index;
+    handle.Generation = timer.Generation;
+    return handle;
+}
+
+// Removes a timer before it expires. Returns false if it already expired or was cancelled.
+bool TimerWheel::Cancel(TimerHandle handle) {
+    if (!Active(handle)) {
+        return false;
+    }
+    Unlink(handle.Index);
+    Free(handle.Index);
+    return true;
+}
+
+// Returns whether a timer is still pending
+bool TimerWheel::Active(TimerHandle handle) const {
+    return handle.Index < Timers.size() && Timers[handle.Index].Generation == handle.Generation && Timers[handle.Index].Bucket != TIMER_NONE;
+}
+
+// Cancels all timers. The current step is kept.
+void TimerWheel::Clear() {
+    for (unsigned int bucket = 0; bucket < Buckets.size(); bucket++) {
+        while (Buckets[bucket] != TIMER_NONE) {
+            unsigned int index = Buckets[bucket];
+            Unlink(index);
+            Free(index);
+        }
+    }
+}
+
+// Files a timer under the slot of its due step, on the lowest level whose span reaches it
+void TimerWheel::Insert(unsigned int index) {
+    unsigned long long due = Timers[index].Due > Current ? Timers[index].Due : Current;
+    unsigned long long delta = due - Current;
+    unsigned int level = 0;
+    while (level + 1 < TIMER_LEVELS && delta >= 1ull << ((level + 1) * TIMER_SLOT_BITS)) {
+        level++;
+    }
+    unsigned int slot = (unsigned int)((due >> (level * TIMER_SLOT_BITS)) & (TIMER_SLOTS - 1));
+    Link(index, level * TIMER_SLOTS + slot);
+}
+
+// Adds a timer to the front of a bucket's list
+void TimerWheel::Link(unsigned int index, unsigned int bucket) {
+    Timer &timer = Timers[index];
+    timer.Bucket = bucket;
+    timer.Prev = TIMER_NONE;
+    timer.Next = Buckets[bucket];
+    if (timer.Next != TIMER_NONE) {
+        Timers[timer.Next].Prev = index;
+    }
+    Buckets[bucket] = index;
+}
+
+// Removes a timer from its bucket's list
+void TimerWheel::Unlink(unsigned int index) {
+    Timer &timer = Timers[index];
+    if (timer.Prev != TIMER_NONE) {
+        Timers[timer.Prev].Next = timer.Next;
+    } else {
+        Buckets[timer.Bucket] = timer.Next;
+    }
+    if (timer.Next != TIMER_NONE) {
+        Timers[timer.Next].Prev = timer.Prev;
+    }
+}
+
+// Returns an unlinked timer to the free list, invalidating its handles
+void TimerWheel::Free(unsigned int index) {
+    Timer &timer = Timers[index];
+    timer.Bucket = TIMER_NONE;
+    timer.Generation = timer.Generation + 1 ? timer.Generation + 1 : 1;
+    timer.Next = FreeHead;
+    FreeHead = index;
+    Count--;
+}
+
+// Empties a bucket and returns the first timer of its former list
+unsigned int TimerWheel::Detach(unsigned int bucket) {
+    unsigned int first = Buckets[bucket];
+    Buckets[bucket] = TIMER_NONE;
+    return first;
+}
+
+// Files the timers of a level's current slot again, which moves them to lower levels. Returns whether the level wrapped around.
+bool TimerWheel::Cascade(unsigned int level) {
+    unsigned int slot = (unsigned int)((Current >> (level * TIMER_SLOT_BITS)) & (TIMER_SLOTS - 1));
+    unsigned int index = Detach(level * TIMER_SLOTS + slot);
+    while (index != TIMER_NONE) {
+        unsigned int next = Timers[index].Next;
+        Insert(index);
+        index = next;
+    }
+    return slot == 0;
+}
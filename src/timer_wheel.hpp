@@ -0,0 +1,100 @@
+/*
+ timer_wheel.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration of the TimerWheel class
+ A hierarchical timer wheel on simulation steps, which expires timed effects without counting each of them down every step.
+ */
+
+#ifndef timer_wheel_hpp
+#define timer_wheel_hpp
+
+#include <vector>
+
+const unsigned int TIMER_SLOT_BITS = 6;
+const unsigned int TIMER_SLOTS = 1 << TIMER_SLOT_BITS; // slots per level
+const unsigned int TIMER_LEVELS = 4; // timers up to 64^4 steps ahead, over 38 hours at 120 steps per second
+const unsigned int TIMER_NONE = 0xFFFFFFFF;
+
+// What a timer does when it expires. The meaning of the kind and the data is up to the owner of the wheel.
+struct TimerEvent {
+    unsigned int Kind;
+    unsigned int Data;
+};
+
+// Refers to a timer until it expires or is cancelled. A handle to an expired timer no longer resolves, even once its storage is reused.
+struct TimerHandle {
+    unsigned int Index = TIMER_NONE;
+    unsigned int Generation = 0;
+};
+
+// Level 0 holds the timers due within the next 64 steps, one slot per step. Each further level holds timers 64 times further
+// ahead, one slot per span of the level below, and a slot is moved down a level when the steps reach its span.
+// Advancing a step thus only touches the timers expiring in it, plus each timer once per level it moves down.
+// Timers live in storage allocated up front and refer to each other by index, and callbacks are passed to Advance rather
+// than stored. A copy of the wheel is therefore a snapshot of all pending timers that can be restored by assignment.
+class TimerWheel {
+public:
+    TimerWheel(unsigned int capacity);
+    
+    unsigned long long Now() const { return Current; } // steps advanced so far
+    unsigned int Pending() const { return Count; }
+    TimerHandle Schedule(unsigned long long delay, TimerEvent event);
+    bool Cancel(TimerHandle handle);
+    bool Active(TimerHandle handle) const;
+    void Clear();
+    template <typename Callback>
+    void Advance(Callback &&expire);
+    
+private:
+    struct Timer {
+        unsigned long long Due; // step in which the timer expires
+        TimerEvent Event;
+        unsigned int Next, Prev; // neighbors in the list of the timer's bucket, or in the free list
+        unsigned int Bucket; // TIMER_NONE while free
+        unsigned int Generation;
+    };
+    
+    static const unsigned int EXPIRING_BUCKET = TIMER_LEVELS * TIMER_SLOTS; // timers expiring in the step being advanced
+    
+    unsigned long long Current;
+    unsigned int Count;
+    unsigned int FreeHead;
+    std::vector<Timer> Timers;
+    std::vector<unsigned int> Buckets; // first timer of each slot of each level, and of the expiring list
+    
+    void Insert(unsigned int index);
+    void Link(unsigned int index, unsigned int bucket);
+    void Unlink(unsigned int index);
+    void Free(unsigned int index);
+    unsigned int Detach(unsigned int bucket);
+    bool Cascade(unsigned int level);
+};
+
+// Expires the timers due in the current step, calling expire with the event of each, and moves on to the next step
+// Callbacks may schedule and cancel timers. A timer scheduled by a callback without delay expires in the next step.
+template <typename Callback>
+void TimerWheel::Advance(Callback &&expire) {
+    unsigned int slot = (unsigned int)(Current & (TIMER_SLOTS - 1));
+    if (slot == 0) {
+        // the first level wrapped around, so the next span of each level above moves down, as far as the levels wrapped
+        for (unsigned int level = 1; level < TIMER_LEVELS && Cascade(level); level++);
+    }
+    // the due timers are moved to a list of their own, as timers scheduled by the callbacks may land in the same slot
+    unsigned int index = Detach(slot);
+    Buckets[EXPIRING_BUCKET] = index;
+    for (; index != TIMER_NONE; index = Timers[index].Next) {
+        Timers[index].Bucket = EXPIRING_BUCKET;
+    }
+    Current++;
+    while (Buckets[EXPIRING_BUCKET] != TIMER_NONE) {
+        index = Buckets[EXPIRING_BUCKET];
+        TimerEvent event = Timers[index].Event;
+        Unlink(index);
+        Free(index);
+        expire(event);
+    }
+}
+
+#endif /* timer_wheel_hpp */
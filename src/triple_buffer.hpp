@@ -0,0 +1,56 @@
+/*
+ triple_buffer.hpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ Declaration and implementation of the TripleBuffer class template
+ A lock-free triple buffer passing the latest value from one writer thread to one reader thread.
+ The writer never waits for the reader and the reader always sees a complete value.
+ */
+
+#ifndef triple_buffer_hpp
+#define triple_buffer_hpp
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+public:
+    // All three slots start as copies of an initial value, so the reader has something to read before the first publish
+    TripleBuffer(const T &initial) : Buffers{initial, initial, initial}, Ready(1), Back(0), Front(2) {}
+    
+    // Slot owned by the writer. Only valid until the next call to Publish.
+    T &Write() {
+        return Buffers[Back];
+    }
+    
+    // Hands the written slot to the reader and takes back the slot it replaces, which the reader is not using
+    void Publish() {
+        Back = Ready.exchange(Back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+    
+    // Switches to the latest published value, if there is one. Returns whether the value changed.
+    bool Acquire() {
+        if (!(Ready.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        Front = Ready.exchange(Front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    
+    // Slot owned by the reader. Only valid until the next call to Acquire.
+    const T &Read() const {
+        return Buffers[Front];
+    }
+    
+private:
+    static const unsigned int INDEX_MASK = 3;
+    static const unsigned int FRESH = 4; // set while the ready slot holds a value the reader has not acquired
+    
+    T Buffers[3];
+    std::atomic<unsigned int> Ready; // slot between the writer and the reader, with the FRESH flag
+    unsigned int Back; // only used by the writer
+    unsigned int Front; // only used by the reader
+};
+
+#endif /* triple_buffer_hpp */
@@ -0,0 +1,345 @@
+/*
+ compress_textures.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ A command-line tool that converts an image into a compressed texture container with a full mip chain.
+ Usage: compress_textures [--flip] [--format bc1|bc3|bc7] <input> [output]
+ The output defaults to the input path with the .ctex extension, which is where ResourceManager looks for it.
+ Opaque images default to BC1 and images with transparency to BC3. Pass --flip for textures the game loads flipped.
+ */
+
+#include "../src/texture_container.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// An uncompressed RGBA8 image
+struct Image {
+    unsigned int Width;
+    unsigned int Height;
+    std::vector<unsigned char> Pixels;
+};
+
+// Halves an image with a box filter. Odd edges reuse the last row or column.
+Image Downsample(const Image &source) {
+    Image result;
+    result.Width = std::max(1u, source.Width / 2);
+    result.Height = std::max(1u, source.Height / 2);
+    result.Pixels.resize(result.Width * result.Height * 4);
+    for (unsigned int y = 0; y < result.Height; y++) {
+        unsigned int y0 = std::min(2 * y, source.Height - 1), y1 = std::min(2 * y + 1, source.Height - 1);
+        for (unsigned int x = 0; x < result.Width; x++) {
+            unsigned int x0 = std::min(2 * x, source.Width - 1), x1 = std::min(2 * x + 1, source.Width - 1);
+            for (unsigned int c = 0; c < 4; c++) {
+                unsigned int sum = source.Pixels[(y0 * source.Width + x0) * 4 + c] + source.Pixels[(y0 * source.Width + x1) * 4 + c]
+                                 + source.Pixels[(y1 * source.Width + x0) * 4 + c] + source.Pixels[(y1 * source.Width + x1) * 4 + c];
+                result.Pixels[(y * result.Width + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+    return result;
+}
+
+// Copies the 4x4 block at a block position into 16 RGBA texels. Texels past the edge repeat the edge.
+void ReadBlock(const Image &image, unsigned int bx, unsigned int by, float texels[16][4]) {
+    for (unsigned int i = 0; i < 16; i++) {
+        unsigned int x = std::min(bx * 4 + i % 4, image.Width - 1);
+        unsigned int y = std::min(by * 4 + i / 4, image.Height - 1);
+        for (unsigned int c = 0; c < 4; c++) {
+            texels[i][c] = image.Pixels[(y * image.Width + x) * 4 + c];
+        }
+    }
+}
+
+// Fits a line through the texels along their principal axis and returns its two ends
+// Only the first numChannels channels are considered
+void FitEndpoints(float texels[16][4], unsigned int numChannels, float start[4], float end[4]) {
+    float mean[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (unsigned int i = 0; i < 16; i++) {
+        for (unsigned int c = 0; c < numChannels; c++) {
+            mean[c] += texels[i][c] / 16.0f;
+        }
+    }
+    float covariance[4][4] = {};
+    for (unsigned int i = 0; i < 16; i++) {
+        for (unsigned int a = 0; a < numChannels; a++) {
+            for (unsigned int b = 0; b < numChannels; b++) {
+                covariance[a][b] += (texels[i][a] - mean[a]) * (texels[i][b] - mean[b]);
+            }
+        }
+    }
+    // power iteration converges to the axis of the largest variance
+    float axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    for (unsigned int iteration = 0; iteration < 8; iteration++) {
+        float next[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float length = 0.0f;
+        for (unsigned int a = 0; a < numChannels; a++) {
+            for (unsigned int b = 0; b < numChannels; b++) {
+                next[a] += covariance[a][b] * axis[b];
+            }
+            length += next[a] * next[a];
+        }
+        if (length < 1e-6f) {
+            break; // every texel has the same color
+        }
+        length = std::sqrt(length);
+        for (unsigned int c = 0; c < numChannels; c++) {
+            axis[c] = next[c] / length;
+        }
+    }
+    float minT = 0.0f, maxT = 0.0f;
+    for (unsigned int i = 0; i < 16; i++) {
+        float t = 0.0f;
+        for (unsigned int c = 0; c < numChannels; c++) {
+            t += (texels[i][c] - mean[c]) * axis[c];
+        }
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (unsigned int c = 0; c < 4; c++) {
+        start[c] = c < numChannels ? std::min(255.0f, std::max(0.0f, mean[c] + minT * axis[c])) : 255.0f;
+        end[c] = c < numChannels ? std::min(255.0f, std::max(0.0f, mean[c] + maxT * axis[c])) : 255.0f;
+    }
+}
+
+// Returns the index of the palette entry closest to a texel
+unsigned int ClosestEntry(const float texel[4], const float palette[][4], unsigned int numEntries, unsigned int numChannels) {
+    unsigned int best = 0;
+    float bestError = 1e30f;
+    for (unsigned int i = 0; i < numEntries; i++) {
+        float error = 0.0f;
+        for (unsigned int c = 0; c < numChannels; c++) {
+            error += (texel[c] - palette[i][c]) * (texel[c] - palette[i][c]);
+        }
+        if (error < bestError) {
+            best = i;
+            bestError = error;
+        }
+    }
+    return best;
+}
+
+// Writes a value of the given number of bits into a little-endian bit stream
+void WriteBits(unsigned char *block, unsigned int &position, unsigned int value, unsigned int numBits) {
+    for (unsigned int i = 0; i < numBits; i++, position++) {
+        if (value & (1u << i)) {
+            block[position / 8] |= (unsigned char)(1u << (position % 8));
+        }
+    }
+}
+
+// Encodes the color of a block as an opaque 8-byte BC1 block
+void EncodeColorBlock(float texels[16][4], unsigned char *block) {
+    float start[4], end[4];
+    FitEndpoints(texels, 3, start, end);
+    unsigned int colors[2];
+    float palette[4][4];
+    const float *ends[2] = {end, start};
+    for (unsigned int e = 0; e < 2; e++) {
+        unsigned int r = (unsigned int)(ends[e][0] * 31.0f / 255.0f + 0.5f);
+        unsigned int g = (unsigned int)(ends[e][1] * 63.0f / 255.0f + 0.5f);
+        unsigned int b = (unsigned int)(ends[e][2] * 31.0f / 255.0f + 0.5f);
+        colors[e] = (r << 11) | (g << 5) | b;
+    }
+    // the first color must be the larger one, otherwise decoders switch to the three-color mode
+    if (colors[0] < colors[1]) {
+        std::swap(colors[0], colors[1]);
+    }
+    for (unsigned int e = 0; e < 2; e++) {
+        unsigned int r = colors[e] >> 11, g = (colors[e] >> 5) & 63, b = colors[e] & 31;
+        palette[e][0] = (float)((r << 3) | (r >> 2));
+        palette[e][1] = (float)((g << 2) | (g >> 4));
+        palette[e][2] = (float)((b << 3) | (b >> 2));
+    }
+    for (unsigned int c = 0; c < 3; c++) {
+        palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+        palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+    }
+    memset(block, 0, 8);
+    unsigned int position = 0;
+    WriteBits(block, position, colors[0], 16);
+    WriteBits(block, position, colors[1], 16);
+    for (unsigned int i = 0; i < 16; i++) {
+        WriteBits(block, position, colors[0] == colors[1] ? 0 : ClosestEntry(texels[i], palette, 4, 3), 2);
+    }
+}
+
+// Encodes the alpha of a block as the 8-byte alpha half of a BC3 block
+void EncodeAlphaBlock(float texels[16][4], unsigned char *block) {
+    float minAlpha = 255.0f, maxAlpha = 0.0f;
+    for (unsigned int i = 0; i < 16; i++) {
+        minAlpha = std::min(minAlpha, texels[i][3]);
+        maxAlpha = std::max(maxAlpha, texels[i][3]);
+    }
+    unsigned int alpha0 = (unsigned int)(maxAlpha + 0.5f), alpha1 = (unsigned int)(minAlpha + 0.5f);
+    // with the first alpha larger, the palette interpolates six values between the two
+    float palette[8][4];
+    palette[0][0] = (float)alpha0;
+    palette[1][0] = (float)alpha1;
+    for (unsigned int i = 2; i < 8; i++) {
+        palette[i][0] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7.0f;
+    }
+    memset(block, 0, 8);
+    unsigned int position = 0;
+    WriteBits(block, position, alpha0, 8);
+    WriteBits(block, position, alpha1, 8);
+    for (unsigned int i = 0; i < 16; i++) {
+        float alpha[4] = {texels[i][3]};
+        WriteBits(block, position, alpha0 == alpha1 ? 0 : ClosestEntry(alpha, palette, 8, 1), 3);
+    }
+}
+
+// Encodes a block as a 16-byte BC7 block in mode 6, a single RGBA line with 4-bit indices
+void EncodeBPTCBlock(float texels[16][4], unsigned char *block) {
+    static const unsigned int weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    float start[4], end[4];
+    FitEndpoints(texels, 4, start, end);
+    // endpoints are stored with 7 bits per channel plus a shared lowest bit per endpoint
+    unsigned int quantized[2][4], pBits[2];
+    const float *ends[2] = {start, end};
+    for (unsigned int e = 0; e < 2; e++) {
+        float bestError = 1e30f;
+        for (unsigned int p = 0; p < 2; p++) {
+            unsigned int candidate[4];
+            float error = 0.0f;
+            for (unsigned int c = 0; c < 4; c++) {
+                candidate[c] = (unsigned int)std::min(127.0f, std::max(0.0f, std::floor((ends[e][c] - p) / 2.0f + 0.5f)));
+                float value = (float)((candidate[c] << 1) | p);
+                error += (value - ends[e][c]) * (value - ends[e][c]);
+            }
+            if (error < bestError) {
+                bestError = error;
+                pBits[e] = p;
+                memcpy(quantized[e], candidate, sizeof(candidate));
+            }
+        }
+    }
+    float palette[16][4];
+    for (unsigned int i = 0; i < 16; i++) {
+        for (unsigned int c = 0; c < 4; c++) {
+            unsigned int e0 = (quantized[0][c] << 1) | pBits[0], e1 = (quantized[1][c] << 1) | pBits[1];
+            palette[i][c] = (float)(((64 - weights[i]) * e0 + weights[i] * e1 + 32) >> 6);
+        }
+    }
+    unsigned int indices[16];
+    for (unsigned int i = 0; i < 16; i++) {
+        indices[i] = ClosestEntry(texels[i], palette, 16, 4);
+    }
+    // the highest bit of the first index is implied to be zero, which is ensured by swapping the endpoints
+    if (indices[0] & 8) {
+        std::swap(quantized[0], quantized[1]);
+        std::swap(pBits[0], pBits[1]);
+        for (unsigned int i = 0; i < 16; i++) {
+            indices[i] = 15 - indices[i];
+        }
+    }
+    memset(block, 0, 16);
+    unsigned int position = 0;
+    WriteBits(block, position, 1u << 6, 7);
+    for (unsigned int c = 0; c < 4; c++) {
+        WriteBits(block, position, quantized[0][c], 7);
+        WriteBits(block, position, quantized[1][c], 7);
+    }
+    WriteBits(block, position, pBits[0], 1);
+    WriteBits(block, position, pBits[1], 1);
+    for (unsigned int i = 0; i < 16; i++) {
+        WriteBits(block, position, indices[i], i == 0 ? 3 : 4);
+    }
+}
+
+// Compresses one mip level
+std::vector<unsigned char> CompressLevel(const Image &image, TextureFormat format) {
+    std::vector<unsigned char> data(TextureLevelSize(format, image.Width, image.Height));
+    size_t blockSize = TextureBlockSize(format);
+    unsigned int blocksX = (image.Width + 3) / 4, blocksY = (image.Height + 3) / 4;
+    for (unsigned int by = 0; by < blocksY; by++) {
+        for (unsigned int bx = 0; bx < blocksX; bx++) {
+            float texels[16][4];
+            ReadBlock(image, bx, by, texels);
+            unsigned char *block = &data[(by * blocksX + bx) * blockSize];
+            if (format == TEXTURE_BC1) {
+                EncodeColorBlock(texels, block);
+            } else if (format == TEXTURE_BC3) {
+                EncodeAlphaBlock(texels, block);
+                EncodeColorBlock(texels, block + 8);
+            } else {
+                EncodeBPTCBlock(texels, block);
+            }
+        }
+    }
+    return data;
+}
+
+int main(int argc, const char *argv[]) {
+    bool flip = false;
+    int format = 0; // chosen from the image when not given
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--flip") {
+            flip = true;
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string name = argv[++i];
+            format = name == "bc1" ? TEXTURE_BC1 : name == "bc3" ? TEXTURE_BC3 : name == "bc7" ? TEXTURE_BC7 : -1;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty() || paths.size() > 2 || format < 0) {
+        std::cout << "Usage: compress_textures [--flip] [--format bc1|bc3|bc7] <input> [output]" << std::endl;
+        return -1;
+    }
+    std::string outputPath = paths.size() > 1 ? paths[1] : TextureContainerPath(paths[0]);
+    
+    Image image;
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(flip);
+    unsigned char *pixels = stbi_load(paths[0].c_str(), &width, &height, &nrChannels, 4);
+    if (!pixels) {
+        std::cout << "ERROR::COMPRESS: Failed to load " << paths[0] << std::endl;
+        return -1;
+    }
+    image.Width = width;
+    image.Height = height;
+    image.Pixels.assign(pixels, pixels + width * height * 4);
+    stbi_image_free(pixels);
+    if (format == 0) {
+        bool opaque = true;
+        for (size_t i = 3; i < image.Pixels.size() && opaque; i += 4) {
+            opaque = image.Pixels[i] == 255;
+        }
+        format = opaque ? TEXTURE_BC1 : TEXTURE_BC3;
+    }
+    
+    TextureContainerHeader header = {TEXTURE_CONTAINER_MAGIC, TEXTURE_CONTAINER_VERSION, (uint32_t)format, image.Width, image.Height, TextureMipCount(image.Width, image.Height), flip ? 1u : 0u, 0};
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        std::cout << "ERROR::COMPRESS: Could not create " << outputPath << std::endl;
+        return -1;
+    }
+    output.write((const char*)&header, sizeof(header));
+    size_t totalSize = 0;
+    for (unsigned int level = 0; level < header.NumLevels; level++) {
+        if (level > 0) {
+            image = Downsample(image);
+        }
+        std::vector<unsigned char> data = CompressLevel(image, (TextureFormat)format);
+        output.write((const char*)data.data(), data.size());
+        totalSize += data.size();
+    }
+    if (!output) {
+        std::cout << "ERROR::COMPRESS: Could not write " << outputPath << std::endl;
+        return -1;
+    }
+    std::cout << "Compressed " << paths[0] << " into " << outputPath << " (" << header.Width << "x" << header.Height << ", " << header.NumLevels << " levels, " << totalSize / 1024 << " KiB)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,362 @@
+/*
+ microbench.cpp
+ Breakout
+ Last updated on October 19, 2026
+
+ A command-line tool that times the game's hot functions on fixed-seed inputs.
+ Usage: microbench [--filter <text>] [--seed <n>] [--output <path>]
+ Runs every benchmark whose name contains the filter and writes the results as JSON to the output (default standard output).
+ Built from this file and every source under src except program.cpp. A hidden window is opened, as some functions need an OpenGL context.
+ */
+
+#include "../src/game.hpp"
+#include "../src/game_level.hpp"
+#include "../src/particle_generator.hpp"
+#include "../src/shader.hpp"
+#include "../src/stream_buffer.hpp"
+#include "../src/resource_manager.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/GLFW3.H>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+const double MIN_BATCH_TIME = 0.05; // seconds a batch of calls must take before it is timed
+const unsigned int REPETITIONS = 7; // batches timed per benchmark, the median is reported
+const unsigned int LEVEL_WIDTH = 800, LEVEL_HEIGHT = 300; // size of the block area in the game
+const char *USAGE = "Usage: microbench [--filter <text>] [--seed <n>] [--output <path>]";
+
+// Shaders of the uniform setter benchmark, the same interface as the game's sprite shader
+const char *VERTEX_SOURCE = "#version 330 core\nlayout (location = 0) in vec2 iPos;\nuniform mat4 projection;\nuniform mat4 model;\nvoid main() { gl_Position = projection * model * vec4(iPos, 0.0, 1.0); }\n";
+const char *FRAGMENT_SOURCE = "#version 330 core\nout vec4 fragColor;\nuniform vec3 spriteColor;\nuniform float time;\nvoid main() { fragColor = vec4(spriteColor * time, 1.0); }\n";
+
+// Timing of a benchmark, in nanoseconds per operation
+struct Result {
+    std::string Name;
+    unsigned long long Operations; // operations per timed batch
+    double Median;
+    double Min;
+};
+
+std::string filter;
+std::vector<Result> results;
+
+// The private members of the game's classes that the benchmarks need, a friend of each of them
+struct MicrobenchAccess {
+    static std::vector<Particle> &Particles(ParticleGenerator &particles) { return particles.Particles; }
+    static unsigned int GetEmptySpot(ParticleGenerator &particles) { return particles.GetEmptySpot(); }
+    static void Init(GameLevel &level, const std::vector<std::vector<unsigned int>> &tileData, unsigned int levelWidth, unsigned int levelHeight) { level.Init(tileData, levelWidth, levelHeight); }
+};
+
+// Keeps the compiler from optimizing away a value that is never used
+template <typename T>
+void Keep(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const void *volatile sink;
+    sink = &value;
+#endif
+}
+
+// Times a function performing a number of operations per call. Calls are batched until a batch takes long enough to time.
+void Run(const std::string &name, unsigned long long operationsPerCall, const std::function<void()> &function) {
+    if (name.find(filter) == std::string::npos) {
+        return;
+    }
+    unsigned long long calls = 1;
+    double elapsed = 0.0;
+    for (;;) {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned long long i = 0; i < calls; i++) {
+            function();
+        }
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= MIN_BATCH_TIME) {
+            break;
+        }
+        calls *= 2;
+    }
+    std::vector<double> times;
+    for (unsigned int repetition = 0; repetition < REPETITIONS; repetition++) {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned long long i = 0; i < calls; i++) {
+            function();
+        }
+        times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (calls * operationsPerCall));
+    }
+    std::sort(times.begin(), times.end());
+    results.push_back({name, calls * operationsPerCall, times[REPETITIONS / 2], times[0]});
+    std::cerr << name << ": " << times[REPETITIONS / 2] << " ns" << std::endl;
+}
+
+// Returns a random float between min and max
+float Random(float min, float max) {
+    return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+// Writes a random level of the given size to a temporary file, in the format of the files in levels/
+std::string WriteLevel(const std::string &name, unsigned int columns, unsigned int rows) {
+    std::string path = (fs::temp_directory_path() / ("breakout_microbench_" + name + ".txt")).string();
+    std::ofstream file(path);
+    for (unsigned int row = 0; row < rows; row++) {
+        for (unsigned int column = 0; column < columns; column++) {
+            file << (rand() % 10 == 0 ? 1 : rand() % 6) << (column + 1 < columns ? " " : "\n");
+        }
+    }
+    return path;
+}
+
+// Collision tests between the objects of a level as the simulation runs them
+void BenchmarkCollisions() {
+    GameLevel level;
+    level.Generate(15, 8, LEVEL_WIDTH, LEVEL_HEIGHT);
+    std::vector<GameObject> &bricks = level.Bricks;
+    std::vector<GameObject> powerUps;
+    std::vector<Ball> balls;
+    for (unsigned int i = 0; i < bricks.size(); i++) {
+        powerUps.push_back(GameObject(glm::vec2(Random(0.0f, 800.0f), Random(0.0f, 600.0f)), POWERUP_SIZE, Texture2D()));
+        balls.push_back(Ball(glm::vec2(Random(0.0f, 800.0f), Random(0.0f, 300.0f)), BALL_RADIUS, BALL_V0, Texture2D()));
+    }
+    GameObject paddle(glm::vec2(350.0f, 580.0f), PADDLE_SIZE, Texture2D());
+    Run("CheckCollisions/aabb", powerUps.size(), [&]() {
+        for (GameObject &powerUp : powerUps) {
+            Keep(CheckCollisions(paddle, powerUp));
+        }
+    });
+    Run("CheckCollisions/ball", bricks.size(), [&]() {
+        for (unsigned int i = 0; i < bricks.size(); i++) {
+            Keep(CheckCollisions(balls[i], bricks[i]));
+        }
+    });
+    std::vector<glm::vec2> directions;
+    for (unsigned int i = 0; i < 1024; i++) {
+        directions.push_back(glm::vec2(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)));
+    }
+    Run("ClosestDir", directions.size(), [&]() {
+        for (const glm::vec2 &direction : directions) {
+            Keep(ClosestDir(direction));
+        }
+    });
+}
+
+// Particle updates of the ball's trail. The share of live particles follows from the time between frames.
+void BenchmarkParticles() {
+    Shader shader;
+    Texture2D texture;
+    StreamBuffer stream;
+    Ball ball(glm::vec2(400.0f, 500.0f), BALL_RADIUS, BALL_V0, Texture2D());
+    for (unsigned int frameRate : {60, 120, 250}) {
+        // two particles are spawned per frame and live for a second, filling 500 particles at 250 frames per second
+        ParticleGenerator particles(shader, texture, 500, stream);
+        float dt = 1.0f / frameRate;
+        for (unsigned int i = 0; i < frameRate * 2; i++) {
+            particles.Update(dt, ball, 2);
+        }
+        Run("ParticleGenerator::Update/" + std::to_string(frameRate) + "fps", 1, [&]() {
+            particles.Update(dt, ball, 2, glm::vec2(BALL_RADIUS / 2.0f));
+        });
+    }
+    for (unsigned int fill : {50, 90, 99, 100}) {
+        // live particles are scattered at random, and one is retired for every particle spawned to hold the fill level
+        ParticleGenerator particles(shader, texture, 500, stream);
+        std::vector<Particle> &pool = MicrobenchAccess::Particles(particles);
+        for (Particle &particle : pool) {
+            particle.Life = (unsigned int)(rand() % 100) < fill ? 1.0f : 0.0f;
+        }
+        std::vector<unsigned int> retired;
+        for (unsigned int i = 0; i < 4096; i++) {
+            retired.push_back(rand() % 500);
+        }
+        unsigned int next = 0;
+        Run("ParticleGenerator::GetEmptySpot/" + std::to_string(fill) + "%", 1, [&]() {
+            unsigned int spot = MicrobenchAccess::GetEmptySpot(particles);
+            pool[spot].Life = 1.0f;
+            if (fill < 100) {
+                unsigned int index = retired[next++ % retired.size()];
+                while (pool[index].Life <= 0.0f) {
+                    index = (index + 1) % 500;
+                }
+                pool[index].Life = 0.0f;
+            }
+        });
+    }
+}
+
+// Level loading from text files, and building a level from its tiles
+void BenchmarkLevels() {
+    struct LevelSize {
+        const char *Name;
+        unsigned int Columns, Rows;
+    };
+    for (LevelSize size : {LevelSize{"small", 15, 8}, LevelSize{"huge", 150, 80}}) {
+        std::string path = WriteLevel(size.Name, size.Columns, size.Rows);
+        GameLevel level;
+        Run(std::string("GameLevel::Load/") + size.Name, 1, [&]() {
+            level.Load(path, LEVEL_WIDTH, LEVEL_HEIGHT);
+        });
+        std::vector<std::vector<unsigned int>> tileData(size.Rows, std::vector<unsigned int>(size.Columns));
+        for (std::vector<unsigned int> &row : tileData) {
+            for (unsigned int &tileCode : row) {
+                tileCode = rand() % 10 == 0 ? 1 : rand() % 6;
+            }
+        }
+        Run(std::string("GameLevel::Init/") + size.Name, 1, [&]() {
+            GameLevel built; // Init appends to the level's blocks
+            MicrobenchAccess::Init(built, tileData, LEVEL_WIDTH, LEVEL_HEIGHT);
+            Keep(built.Bricks.size());
+        });
+        fs::remove(path);
+    }
+}
+
+// Powerup updates, where half of the powerups are falling and half are collected, and spawns and releases in a half-full pool
+void BenchmarkPowerUps() {
+    for (unsigned int count : {16, 256, 4096}) {
+        Game game(800, 600);
+        for (unsigned int i = 0; i < count; i++) {
+            PowerUpHandle handle = game.PowerUps.Spawn((PowerUpType)(rand() % NUM_POWERUP_TYPES), glm::vec2(Random(0.0f, 740.0f), Random(0.0f, 300.0f)));
+            if (i % 2 == 1) {
+                game.PowerUps.Activate(handle.Index);
+            }
+        }
+        Run("Game::UpdatePowerUps/" + std::to_string(count), 1, [&]() {
+            game.UpdatePowerUps(1.0f / (float)SIMULATION_RATE);
+        });
+    }
+    
+    PowerUpPool pool;
+    for (unsigned int i = 0; i < POWERUP_POOL_CAPACITY / 2; i++) {
+        pool.Spawn(POWERUP_SPEED, glm::vec2(0.0f));
+    }
+    std::vector<unsigned int> slots(64);
+    Run("PowerUpPool::Spawn+Release", (unsigned int)slots.size(), [&]() {
+        for (unsigned int &slot : slots) {
+            slot = pool.Spawn(POWERUP_CHAOS, glm::vec2(0.0f)).Index;
+        }
+        for (unsigned int slot : slots) {
+            pool.Release(slot);
+        }
+    });
+}
+
+// Timer wheel steps with many pending timers, which are scheduled again as they expire to keep their number, and scheduling and cancelling a timer
+void BenchmarkTimers() {
+    for (unsigned int count : {16, 256, 4096}) {
+        TimerWheel timers(count + 1);
+        for (unsigned int i = 0; i < count; i++) {
+            timers.Schedule(rand() % 100000, {0, i});
+        }
+        Run("TimerWheel::Advance/" + std::to_string(count), 1, [&]() {
+            timers.Advance([&](TimerEvent event) {
+                timers.Schedule(100000, event);
+            });
+        });
+    }
+    
+    TimerWheel timers(POWERUP_POOL_CAPACITY);
+    Run("TimerWheel::Schedule+Cancel", 1, [&]() {
+        timers.Cancel(timers.Schedule(rand() % 1000, {0, 0}));
+    });
+}
+
+// Uniform uploads through the name-based setters of the Shader class
+void BenchmarkUniforms() {
+    Shader shader;
+    shader.Compile(VERTEX_SOURCE, FRAGMENT_SOURCE);
+    glm::mat4 model(1.0f);
+    glm::vec3 color(0.5f);
+    Run("Shader::setMat4", 1, [&]() {
+        shader.setMat4("model", model);
+    });
+    Run("Shader::setVec3", 1, [&]() {
+        shader.setVec3("spriteColor", color);
+    });
+    Run("Shader::setFloat", 1, [&]() {
+        shader.setFloat("time", 1.0f);
+    });
+    glFinish();
+}
+
+int main(int argc, const char *argv[]) {
+    std::string outputPath;
+    unsigned int seed = 1;
+    for (int i = 1; i < argc; i += 2) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cout << "ERROR::ARGUMENTS: Missing value for " << arg << "\n" << USAGE << std::endl;
+            return -1;
+        }
+        if (arg == "--filter") {
+            filter = argv[i + 1];
+        } else if (arg == "--seed") {
+            try {
+                seed = (unsigned int)std::stoul(argv[i + 1]);
+            } catch (std::logic_error &e) {
+                std::cout << "ERROR::ARGUMENTS: Invalid value for " << arg << "\n" << USAGE << std::endl;
+                return -1;
+            }
+        } else if (arg == "--output") {
+            outputPath = argv[i + 1];
+        } else {
+            std::cout << "ERROR::ARGUMENTS: Unknown option " << arg << "\n" << USAGE << std::endl;
+            return -1;
+        }
+    }
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    GLFWwindow *window = glfwCreateWindow(64, 64, "microbench", NULL, NULL);
+    if (window == NULL) {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+
+    // every benchmark starts from the seed, so adding a benchmark does not change the inputs of the others
+    for (void (*benchmark)() : {BenchmarkCollisions, BenchmarkParticles, BenchmarkLevels, BenchmarkPowerUps, BenchmarkTimers, BenchmarkUniforms}) {
+        srand(seed);
+        benchmark();
+    }
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n  \"seed\": " << seed << ",\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [";
+    for (unsigned int i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        json << (i ? ",\n" : "\n") << "    {\"name\": \"" << result.Name << "\", \"operations\": " << result.Operations << ", \"median\": " << result.Median << ", \"min\": " << result.Min << "}";
+    }
+    json << "\n  ]\n}\n";
+
+    ResourceManager::CleanUp();
+    glfwTerminate();
+    if (outputPath.empty()) {
+        std::cout << json.str();
+    } else if (!(std::ofstream(outputPath) << json.str())) {
+        std::cout << "ERROR::MICROBENCH: Could not write " << outputPath << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ pack_assets.cpp
+ Breakout
+ Last updated on October 19, 2026
+ 
+ A command-line tool that packs the game's assets into a single archive read by the AssetArchive class.
+ Usage: pack_assets [output] [root]
+ Packs every file under the asset folders of root (default .) into output (default assets.pak).
+ */
+
+#include "../src/asset_archive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Folders packed into the archive, relative to the root
+const char *ASSET_FOLDERS[] = {"audio", "fonts", "levels", "shaders", "textures"};
+
+// Rounds an offset up to the alignment of asset data
+uint64_t Align(uint64_t offset) {
+    return (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+}
+
+int main(int argc, const char *argv[]) {
+    std::string outputPath = argc > 1 ? argv[1] : "assets.pak";
+    fs::path root = argc > 2 ? argv[2] : ".";
+    
+    // collects the assets in a stable order, so that packing the same files gives the same archive
+    std::vector<std::string> paths;
+    for (const char *folder : ASSET_FOLDERS) {
+        if (!fs::is_directory(root / folder)) {
+            continue;
+        }
+        for (const fs::directory_entry &file : fs::recursive_directory_iterator(root / folder)) {
+            if (!file.is_regular_file() || file.path().filename().string()[0] == '.') {
+                continue;
+            }
+            std::string path = fs::relative(file.path(), root).generic_string();
+            if (path.size() >= ARCHIVE_PATH_LENGTH) {
+                std::cout << "ERROR::PACK: Path too long: " << path << std::endl;
+                return -1;
+            }
+            paths.push_back(path);
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    
+    // lays out the index, then the data of every asset
+    ArchiveHeader header = {ARCHIVE_MAGIC, ARCHIVE_VERSION, (uint32_t)paths.size(), 0};
+    std::vector<ArchiveEntry> entries(paths.size());
+    uint64_t offset = Align(sizeof(ArchiveHeader) + entries.size() * sizeof(ArchiveEntry));
+    for (size_t i = 0; i < paths.size(); i++) {
+        memset(&entries[i], 0, sizeof(ArchiveEntry));
+        strncpy(entries[i].Path, paths[i].c_str(), ARCHIVE_PATH_LENGTH - 1);
+        entries[i].Offset = offset;
+        entries[i].Size = fs::file_size(root / paths[i]);
+        offset = Align(offset + entries[i].Size);
+    }
+    
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        std::cout << "ERROR::PACK: Could not create " << outputPath << std::endl;
+        return -1;
+    }
+    output.write((const char*)&header, sizeof(header));
+    output.write((const char*)entries.data(), entries.size() * sizeof(ArchiveEntry));
+    for (const ArchiveEntry &entry : entries) {
+        std::ifstream input(root / entry.Path, std::ios::binary);
+        std::vector<char> data(entry.Size);
+        if (!input.read(data.data(), data.size())) {
+            std::cout << "ERROR::PACK: Could not read " << entry.Path << std::endl;
+            return -1;
+        }
+        output.seekp(entry.Offset);
+        output.write(data.data(), data.size());
+    }
+    if (!output) {
+        std::cout << "ERROR::PACK: Could not write " << outputPath << std::endl;
+        return -1;
+    }
+    std::cout << "Packed " << entries.size() << " assets into " << outputPath << " (" << offset << " bytes)" << std::endl;
+    return 0;
+}